@@ -79,4 +79,98 @@ void FILTER_AVG_CalcMovAvg(FILTER_AVG_Object_t* const a_pHandler, uint16_t a_u16
     a_pHandler->u16MovAvg = divU16_U32byU16(a_pHandler->u32MovAvgxN, a_pHandler->u16Size);
 }
 
+/**
+ * @brief Initialize a filter bank, clear all variables
+ * @param a_pHandler The handle (pointer to FILTER_AVG_Bank_t structure) to the AVG bank
+ * @returns  true  in case of success
+ */
+bool FILTER_AVG_InitBank(FILTER_AVG_Bank_t* const a_pHandler)
+{
+    uint16_t u16Channel;
+
+    a_pHandler->u16RawIdx = 0u;
+    a_pHandler->u16RawEnd = a_pHandler->u16Size * a_pHandler->u16NrOfChannels;
+
+    if ((a_pHandler->u16Size < 2) || (a_pHandler->u16Size & (a_pHandler->u16Size - 1)))
+    {
+        return false;  /* size shall be in a powers of 2, i.e. 8, 16, 32 etc */
+    }
+
+    if ((a_pHandler->pu16MovAvg == NULL) || (a_pHandler->pu32MovAvgxN == NULL))
+    {
+        return false;
+    }
+
+    a_pHandler->u16Shift = 0u;
+    while ((1u << a_pHandler->u16Shift) < a_pHandler->u16Size)
+    {
+        a_pHandler->u16Shift++;
+    }
+
+    for (u16Channel = 0u; u16Channel < a_pHandler->u16NrOfChannels; u16Channel++)
+    {
+        a_pHandler->pu16MovAvg[u16Channel] = 0u;
+        a_pHandler->pu32MovAvgxN[u16Channel] = 0u;
+    }
+
+    if (a_pHandler->pu16Raw != NULL)
+    {
+        memset(&a_pHandler->pu16Raw[0], 0, a_pHandler->u16RawEnd * 2);
+    }
+
+    return true;
+}
+
+/**
+ * @brief add a row of values to the bank and calculates the moving average of every channel
+ * @param a_pHandler The handle (pointer to FILTER_AVG_Bank_t structure) to the AVG bank
+ * @param a_au16NewValue A new value per channel [u16NrOfChannels]
+ */
+void FILTER_AVG_CalcBank(FILTER_AVG_Bank_t* const a_pHandler, const uint16_t a_au16NewValue[])
+{
+    uint16_t *pu16Element = &a_pHandler->pu16Raw[a_pHandler->u16RawIdx];
+    uint32_t *pu32MovAvgxN = a_pHandler->pu32MovAvgxN;
+    uint16_t *pu16MovAvg = a_pHandler->pu16MovAvg;
+    uint16_t u16Shift = a_pHandler->u16Shift;
+    uint16_t u16Channel;
+
+    for (u16Channel = a_pHandler->u16NrOfChannels; u16Channel != 0u; u16Channel--)
+    {
+        uint16_t u16NewValue = *a_au16NewValue++;
+        uint32_t u32MovAvgxN = *pu32MovAvgxN - *pu16Element + u16NewValue;  /* Replace oldest by newest element */
+        *pu16Element++ = u16NewValue;
+        *pu32MovAvgxN++ = u32MovAvgxN;
+        *pu16MovAvg++ = (uint16_t)(u32MovAvgxN >> u16Shift);
+    }
+
+    a_pHandler->u16RawIdx += a_pHandler->u16NrOfChannels;  /* Next row */
+    if (a_pHandler->u16RawIdx >= a_pHandler->u16RawEnd)
+    {
+        a_pHandler->u16RawIdx = 0u;
+    }
+}
+
+/**
+ * @brief add a row of values to the bank and calculates the exponential average of every channel
+ *
+ * First order IIR filter avg += (new - avg) / u16Size, a time constant of u16Size updates.
+ * The sample buffer is not used.
+ * @param a_pHandler The handle (pointer to FILTER_AVG_Bank_t structure) to the AVG bank
+ * @param a_au16NewValue A new value per channel [u16NrOfChannels]
+ */
+void FILTER_AVG_CalcBankExp(FILTER_AVG_Bank_t* const a_pHandler, const uint16_t a_au16NewValue[])
+{
+    uint32_t *pu32MovAvgxN = a_pHandler->pu32MovAvgxN;
+    uint16_t *pu16MovAvg = a_pHandler->pu16MovAvg;
+    uint16_t u16Shift = a_pHandler->u16Shift;
+    uint16_t u16Channel;
+
+    for (u16Channel = a_pHandler->u16NrOfChannels; u16Channel != 0u; u16Channel--)
+    {
+        uint32_t u32MovAvgxN = *pu32MovAvgxN - *pu16MovAvg + *a_au16NewValue++;
+        *pu32MovAvgxN++ = u32MovAvgxN;
+        *pu16MovAvg++ = (uint16_t)(u32MovAvgxN >> u16Shift);
+    }
+}
+
 /* EOF */
@@ -37,12 +37,33 @@ typedef struct FILTER_AVG_Object_s
     uint16_t u16RawIdx;    /**< Index */
 } FILTER_AVG_Object_t;
 
+/**
+ * The structure of a FILTER_AVG bank: several channels with the same filter length that are
+ * updated together, stored as struct of arrays.
+ * The sample buffer holds u16Size rows of u16NrOfChannels samples, one row per update.
+ * The exponential filter keeps no samples, pu16Raw may be NULL for it.
+ */
+typedef struct FILTER_AVG_Bank_s
+{
+    uint16_t* pu16MovAvg;       /**< Average per channel [u16NrOfChannels] */
+    uint32_t* pu32MovAvgxN;     /**< Average x u16Size per channel [u16NrOfChannels] */
+    uint16_t* pu16Raw;          /**< Buffer address [u16Size * u16NrOfChannels] */
+    uint16_t u16NrOfChannels;   /**< Number of channels */
+    uint16_t u16Size;           /**< Number of elements per channel @warning should be a power of 2 */
+    uint16_t u16Shift;          /**< log2(u16Size), set by FILTER_AVG_InitBank() */
+    uint16_t u16RawIdx;         /**< Index of the oldest row in pu16Raw */
+    uint16_t u16RawEnd;         /**< u16Size * u16NrOfChannels, set by FILTER_AVG_InitBank() */
+} FILTER_AVG_Bank_t;
+
 /* ---------------------------
  * Public Function Definitions
  * --------------------------- */
 
 bool FILTER_AVG_Init(FILTER_AVG_Object_t* const handler);
 void FILTER_AVG_CalcMovAvg(FILTER_AVG_Object_t* const handler, uint16_t a_u16NewValue);
+bool FILTER_AVG_InitBank(FILTER_AVG_Bank_t* const handler);
+void FILTER_AVG_CalcBank(FILTER_AVG_Bank_t* const handler, const uint16_t a_au16NewValue[]);
+void FILTER_AVG_CalcBankExp(FILTER_AVG_Bank_t* const handler, const uint16_t a_au16NewValue[]);
 
 static __inline__ __attribute__ ((__always_inline__))
 uint16_t get_u16MovAvg(const FILTER_AVG_Object_t* const handler)
@@ -36,6 +36,16 @@
 /** start address of the user eeprom */
 #define NV_ADDR_PATTERN ((uint16_t)EEPROM_START + 0x40u)
 
+#ifdef UNITTEST
+/** EEPROM image provided by the test environment */
+extern uint8_t g_au8HostEeprom[];
+/** pointer to an EEPROM address inside the test environment EEPROM image */
+#define NV_PTR(addr) ((void *)&g_au8HostEeprom[(uint16_t)(addr) - (uint16_t)EEPROM_START])
+#else
+/** pointer to an EEPROM address */
+#define NV_PTR(addr) ((void *)(addr))
+#endif /* UNITTEST */
+
 /** eeprom write key */
 #define EE_WRITE_KEY 0x07u
 
@@ -74,7 +84,7 @@ bool unirom_LoadUserConfig(void)
         uint16_t eeprom_address = NV_ADDR_PATTERN + (page * sizeof(page_t) / sizeof(uint8_t));
 
         /* copy one page from EEPROM to RAM */
-        memcpy((void*)&l_ramCopy.page[page], (void*)eeprom_address, sizeof(page_t) / sizeof(uint8_t));
+        memcpy((void*)&l_ramCopy.page[page], NV_PTR(eeprom_address), sizeof(page_t) / sizeof(uint8_t));
 
         if (EEPROM_GetErrorFlags())
         {
@@ -114,7 +124,7 @@ bool unirom_StoreUserConfig(void)
         uint16_t eeprom_address = NV_ADDR_PATTERN + (page * sizeof(page_t) / sizeof(uint8_t));
 
         /* Check if EEPROM and RAM copy are not the same */
-        if (!_pageVerify(&l_ramCopy.page[page], (uint16_t *)eeprom_address))
+        if (!_pageVerify(&l_ramCopy.page[page], (uint16_t *)NV_PTR(eeprom_address)))
         {
             /* write to eeprom page */
             ENTER_SECTION(ATOMIC_SYSTEM_MODE);
@@ -133,7 +143,7 @@ bool unirom_StorePage(uint8_t page)
     uint16_t eeprom_address = NV_ADDR_PATTERN + (page * sizeof(page_t) / sizeof(uint8_t));
 
     /* Check if EEPROM and RAM copy are not the same */
-    if (!_pageVerify(&l_ramCopy.page[page], (uint16_t *)eeprom_address))
+    if (!_pageVerify(&l_ramCopy.page[page], (uint16_t *)NV_PTR(eeprom_address)))
     {
         /* write to eeprom page */
         ENTER_SECTION(ATOMIC_SYSTEM_MODE);
@@ -81,8 +81,22 @@ struct
 		int16_t lastAngle; /*  */
 		uint16_t code_1;   /*  */
 		uint16_t code_2;   /*  */
+		int16_t backlash;  /* gearbox play of the last calibration [0.1deg], -1: none */
+		int16_t travel;	   /* Mode A minus Mode B of the last full calibration [0.1deg], 0: none */
+		uint8_t recordValid;		/* 1: record holds the stored calibration record */
+		uint8_t bootCheck;			/* 1: record accepted at power on, the next move has to end in the accuracy window */
+		valve_cal_record_t record;	/* calibration record as stored */
 	} memory;
 
+	struct
+	{
+		uint8_t armed;	 /* 1: targetAngle is held */
+		uint8_t count;	 /* samples off the target in a row */
+		uint8_t retries; /* corrections without a quiet time in between */
+		uint16_t timer;	 /* time to the next sample [ms] */
+		uint16_t quiet;	 /* time in the window [ms] */
+	} hold;
+
 	struct
 	{
 		struct
@@ -170,6 +184,26 @@ static void ValveFaultReset(void)
 	valve.diag.temp.retryCnt = 0;
 }
 
+/* 1: travel is a plausible Mode A minus Mode B angle [0.1deg] */
+static uint8_t ValveTravelValid(int16_t travel)
+{
+	int16_t diff = travel - (int16_t)C_VALVE_CAL_TRAVEL;
+
+	if (diff < 0)
+	{
+		diff = -diff;
+	}
+	return (uint8_t)(diff <= (int16_t)C_VALVE_CAL_TRAVEL_TOL);
+}
+
+/* 1: angle lies between the end stops of the Mode B angle angleB and the Mode A angle angleA,
+   with a margin of C_VALVE_ACCURACY_ANGLE [0.1deg] */
+static uint8_t ValveWithinStops(int16_t angle, int16_t angleB, int16_t angleA)
+{
+	return (uint8_t)((angle >= (angleB - (int16_t)C_STOPPER_0D_ANGLE - (int16_t)C_VALVE_ACCURACY_ANGLE)) &&
+					 (angle <= (angleA + (int16_t)C_STOPPER_360D_ANGLE + (int16_t)C_VALVE_ACCURACY_ANGLE)));
+}
+
 static tValveState ValveInitTask(void)
 {
 	tValveState nextState = VALVE_INIT;
@@ -183,7 +217,33 @@ static tValveState ValveInitTask(void)
 		{
 			valve.calibration.req2Cal = 1;
 		}
-		if (valve.memory.lastAngle != 0)
+		if (valve.memory.recordValid != 0u)
+		{
+			/* the stored calibration holds while the valve stands between its end stops, near
+			   the angle of the last power off */
+			diff = valve.pos.currentAngle - valve.memory.lastAngle;
+			if (diff < 0)
+			{
+				diff = -diff;
+			}
+			if ((ValveWithinStops(valve.pos.currentAngle, valve.pos.modeAngle[C_MODE_B], valve.pos.modeAngle[C_MODE_A]) == 0u) ||
+				((valve.memory.lastAngle != 0) && (diff > (int16_t)C_VALVE_BOOT_WINDOW)))
+			{
+				valve.calibration.req2Cal = 1;
+			}
+			else
+			{
+				/* a valve turned while unpowered returns to the commanded mode, the record
+				   has to prove itself on that move, see ValveOperationTask() */
+				valve.comm.lastMode = 0xFFu;
+				if (valve.comm.targetMode <= C_MODE_B)
+				{
+					ValveTargetAngleUpdate(valve.pos.modeAngle[valve.comm.targetMode]);
+				}
+				valve.memory.bootCheck = 1u;
+			}
+		}
+		else if (valve.memory.lastAngle != 0)
 		{
 			diff = valve.pos.currentAngle - valve.memory.lastAngle;
 			if (diff < 0)
@@ -222,6 +282,67 @@ static tValveState ValveInitTask(void)
 	return nextState;
 }
 
+#if POSITION_HOLD_ENABLE == 1
+/*
+drift watchdog of the position hold, 1ms in standby
+The valve angle is sampled every C_VALVE_HOLD_SAMPLE_MS once the valve stood
+C_VALVE_HOLD_SETTLE_MS. C_VALVE_HOLD_CONFIRM samples in a row off the target by more than
+C_VALVE_HOLD_WINDOW re-close the loop: the motor corrects with FINE pulses from the holding
+duty on, or with a move for a larger drift. Armed by a move that ended in the accuracy window.
+After C_VALVE_HOLD_RETRIES corrections without C_VALVE_HOLD_QUIET_MS in the window in between
+something holds the valve off the target: the hold gives up with valve.pos.fault, the protection
+reports SENSOR_POS_ERROR and commands the mode again once the fault is cleared.
+*/
+static uint8_t ValveHoldWatchdog(int16_t diffPos)
+{
+	uint8_t correct = 0u;
+
+	if (valve.hold.armed == 0u)
+	{
+	}
+	else if (valve.hold.timer != 0u)
+	{
+		valve.hold.timer--;
+	}
+	else
+	{
+		valve.hold.timer = C_VALVE_HOLD_SAMPLE_MS - 1u;
+		if (diffPos > (int16_t)C_VALVE_HOLD_WINDOW)
+		{
+			valve.hold.quiet = 0u;
+			valve.hold.count++;
+			if (valve.hold.count >= C_VALVE_HOLD_CONFIRM)
+			{
+				valve.hold.count = 0u;
+				if (valve.hold.retries >= C_VALVE_HOLD_RETRIES)
+				{
+					valve.hold.armed = 0u;
+					valve.pos.fault = 1;
+				}
+				else
+				{
+					valve.hold.retries++;
+					correct = 1u;
+				}
+			}
+		}
+		else
+		{
+			valve.hold.count = 0u;
+			if (valve.hold.quiet < C_VALVE_HOLD_QUIET_MS)
+			{
+				valve.hold.quiet += C_VALVE_HOLD_SAMPLE_MS;
+			}
+			else
+			{
+				valve.hold.retries = 0u;
+			}
+		}
+	}
+	return correct;
+}
+#endif
+
 static tValveState ValveStandbyTask(void)
 {
 
@@ -231,18 +352,20 @@ static tValveState ValveStandbyTask(void)
 	if (valve.initStatus != 0)
 	{
 		valve.initStatus = 0;
+		valve.hold.timer = C_VALVE_HOLD_SETTLE_MS;
+		valve.hold.count = 0u;
 	}
 
 	MotRequestHardStop();
 
 	if ((valve.calibration.req2Cal == 1) || (valve.calibration.req1Cal == 1))
 	{
-
+		valve.hold.armed = 0u;
 		nextState = VALVE_CALIBRATION;
 	}
 	else if (valve.comm.ForcedDiag != 0)
 	{
-
+		valve.hold.armed = 0u;
 		nextState = VALVE_DIAGRUN;
 	}
 	else if (valve.comm.Enable != 0)
@@ -263,11 +386,22 @@ static tValveState ValveStandbyTask(void)
 			nextState = VALVE_READY;
 		}
 #else
-		if ((valve.comm.lastMode != valve.comm.targetMode) && (diffPos >= (int16_t)C_VALVE_ACCURACY_ANGLE))
+		if ((valve.comm.lastMode != valve.comm.targetMode) && ((diffPos >= (int16_t)C_VALVE_ACCURACY_ANGLE) || (valve.memory.bootCheck != 0u)))
 		{
-
+			valve.hold.retries = 0u;
 			nextState = VALVE_READY;
 		}
+#if POSITION_HOLD_ENABLE == 1
+		else if (ValveHoldWatchdog(diffPos) != 0u)
+		{
+			/* drifted off the target: the same target again re-closes the loop */
+			nextState = VALVE_READY;
+		}
+		else if (valve.pos.fault != 0)
+		{
+			nextState = VALVE_PROTECTION;
+		}
+#endif
 #endif
 		valve.comm.lastMode = valve.comm.targetMode;
 	}
@@ -309,14 +443,14 @@ static tValveState ValveOperationTask(void)
 
 	if (valve.elapsedTime >= valve.comm.timeOut)
 	{
-
+		valve.hold.armed = 0u;
 		valve.pos.fault = 1;
 		nextState = VALVE_PROTECTION;
 	}
 	else
 	{
 #if POINT_TEST_ENABLE == 1
-		if ((valve.motorMotion >= MOTION_ACC) && (valve.motorMotion <= MOTION_DEC))
+		if ((valve.motorMotion >= MOTION_ACC) && (valve.motorMotion <= MOTION_FINE))
 		{
 		}
 		else
@@ -324,8 +458,15 @@ static tValveState ValveOperationTask(void)
 			nextState = VALVE_STANDBY;
 		}
 #else
-		if ((valve.motorMotion >= MOTION_ACC) && (valve.motorMotion <= MOTION_DEC))
+		if ((valve.motorMotion >= MOTION_ACC) && (valve.motorMotion <= MOTION_FINE))
 		{
+			if ((valve.comm.Enable != 0) && (valve.comm.lastMode != valve.comm.targetMode))
+			{
+				/* new mode during the move: the motor blends it in, the timeout restarts */
+				MotSetTargetPosition(valve.pos.targetAngle);
+				valve.comm.lastMode = valve.comm.targetMode;
+				valve.elapsedTime = 0;
+			}
 		}
 		else
 		{
@@ -368,12 +509,21 @@ static tValveState ValveOperationTask(void)
 				valve.pos.fault = 1;
 			}
 #endif
+			if ((valve.pos.fault != 0) && (valve.memory.bootCheck != 0u))
+			{
+				/* the calibration record accepted at power on missed the mode: calibrate */
+				valve.pos.fault = 0;
+				valve.calibration.req2Cal = 1;
+			}
+			valve.memory.bootCheck = 0u;
 			if (valve.pos.fault != 0)
 			{
+				valve.hold.armed = 0u;
 				nextState = VALVE_PROTECTION;
 			}
 			else
 			{
+				valve.hold.armed = 1u;
 				nextState = VALVE_STANDBY;
 			}
 		}
@@ -410,6 +560,123 @@ static void calcSensorOffset(int16_t currDegree)
 
 	set_gmr_sensor_offset(offset);
 }
+
+#if QUICK_CALIBRATION_ENABLE == 1
+/* angle folded into 0~C_GMR_SENSOR_ANGLE_LIMIT */
+static int16_t ValveCalWrap(int16_t angle)
+{
+	if (angle >= (int16_t)C_GMR_SENSOR_ANGLE_LIMIT)
+	{
+		angle -= (int16_t)C_GMR_SENSOR_ANGLE_LIMIT;
+	}
+	else if (angle < 0)
+	{
+		angle += (int16_t)C_GMR_SENSOR_ANGLE_LIMIT;
+	}
+	else
+	{
+	}
+	return angle;
+}
+
+/*
+plausibility of a quick calibration
+The quick calibration touches the nearer end stop only and places the other end with the
+travel of the last full calibration. It is accepted when the touched end stop is within
+C_VALVE_QUICKCAL_WINDOW of the angle the stored calibration expects, and the angle stored at
+the last power off lies between the end stops. Otherwise the full sweep follows.
+error: touched end stop minus its expected angle [0.1deg]
+angleB: Mode B angle of the quick calibration [0.1deg]
+*/
+static uint8_t ValveQuickCalCheck(int16_t error, int16_t angleB)
+{
+	uint8_t ok = 1u;
+
+	if (error > (int16_t)(C_GMR_SENSOR_ANGLE_LIMIT / 2))
+	{
+		error -= (int16_t)C_GMR_SENSOR_ANGLE_LIMIT;
+	}
+	else if (error < -(int16_t)(C_GMR_SENSOR_ANGLE_LIMIT / 2))
+	{
+		error += (int16_t)C_GMR_SENSOR_ANGLE_LIMIT;
+	}
+	else
+	{
+	}
+	if ((error > (int16_t)C_VALVE_QUICKCAL_WINDOW) || (error < -(int16_t)C_VALVE_QUICKCAL_WINDOW))
+	{
+		ok = 0u;
+	}
+	else if ((valve.memory.lastAngle != 0) && (ValveWithinStops(valve.memory.lastAngle, angleB, angleB + valve.memory.travel) == 0u))
+	{
+		ok = 0u;
+	}
+	else
+	{
+	}
+	return ok;
+}
+#endif
+
+/* 1: a differs from b by more than C_VALVE_CAL_HYSTERISYS */
+static uint8_t ValveCalMoved(int16_t a, int16_t b)
+{
+	int16_t diff = a - b;
+
+	if (diff < 0)
+	{
+		diff = -diff;
+	}
+	return (uint8_t)(diff > (int16_t)C_VALVE_CAL_HYSTERISYS);
+}
+
+/*
+store the calibration record after a completed calibration
+The record is rewritten only when an angle or the gearbox play moved more than
+C_VALVE_CAL_HYSTERISYS, the GMR correction moved the angle (gmr_correction_moved()) or another
+measured value changed, a quick calibration on every ignition off mostly leaves the eeprom alone.
+*/
+static void ValveStoreCalRecord(void)
+{
+	valve_cal_record_t record;
+	gmr_correction_t corr, stored;
+
+	get_gmr_correction(&corr);
+	record.generation = (uint8_t)(valve.memory.record.generation + 1u);
+	record.gmrOffset = get_gmr_sensor_offset();
+	record.d0Angle = valve.pos.modeAngle[C_MODE_B];
+	record.d360Angle = valve.pos.modeAngle[C_MODE_A];
+	record.travel = valve.memory.travel;
+	record.backlash = valve.memory.backlash;
+	record.sinOffset = corr.sinOffset;
+	record.cosOffset = corr.cosOffset;
+	record.sinAmplitude = corr.sinAmplitude;
+	record.cosAmplitude = corr.cosAmplitude;
+	record.quadrature = corr.quadrature;
+	record.harmCos = corr.harmCos;
+	record.harmSin = corr.harmSin;
+	stored.sinOffset = valve.memory.record.sinOffset;
+	stored.cosOffset = valve.memory.record.cosOffset;
+	stored.sinAmplitude = valve.memory.record.sinAmplitude;
+	stored.cosAmplitude = valve.memory.record.cosAmplitude;
+	stored.quadrature = valve.memory.record.quadrature;
+	stored.harmCos = valve.memory.record.harmCos;
+	stored.harmSin = valve.memory.record.harmSin;
+	if ((valve.memory.recordValid == 0u) ||
+		(ValveCalMoved(record.gmrOffset, valve.memory.record.gmrOffset) != 0u) ||
+		(ValveCalMoved(record.d0Angle, valve.memory.record.d0Angle) != 0u) ||
+		(ValveCalMoved(record.d360Angle, valve.memory.record.d360Angle) != 0u) ||
+		(record.travel != valve.memory.record.travel) ||
+		((record.backlash < 0) != (valve.memory.record.backlash < 0)) ||
+		(ValveCalMoved(record.backlash, valve.memory.record.backlash) != 0u) ||
+		(gmr_correction_moved(&corr, &stored) != 0u))
+	{
+		(void)eeprom_WriteCalRecord(&record);
+		valve.memory.record = record;
+		valve.memory.recordValid = 1u;
+	}
+}
+
 static tValveState ValveCalibrationTask(void)
 {
 	tValveState nextState = VALVE_CALIBRATION;
@@ -441,8 +708,21 @@ static tValveState ValveCalibrationTask(void)
 		break;
 	case CALSTEP_START:
 		MotClearHardStop();
+		MotSetEndStopConfirm(C_VALVE_CAL_ENDSTOP_CONFIRM);
 		valve.calibration.delay = 3;
 		valve.calibration.timer = 0;
+#if QUICK_CALIBRATION_ENABLE == 1
+		if ((valve.calibration.req2Cal == 0) && (ValveTravelValid(valve.memory.travel) == 0))
+		{
+			valve.calibration.req2Cal = 1; /* no travel of a full calibration to apply */
+		}
+#endif
+#if GMR_FIT_ENABLE == 1
+		if (gmr_fit_Apply() != 0u)
+		{
+			valve.calibration.req2Cal = 1; /* the angles of the stored end stops no longer fit the new correction */
+		}
+#endif
 		if (valve.calibration.req2Cal != 0)
 		{
 			ValveTargetAngleUpdate(-10 * C_GMR_ANGLE_SCALE_FACTOR); /* move to 0% position */
@@ -483,6 +763,17 @@ static tValveState ValveCalibrationTask(void)
 			{
 				MotClearStallFlag(0); /* clear stall flag if set */
 				MotRequestHardStop();
+#if QUICK_CALIBRATION_ENABLE == 1
+				if (valve.calibration.req2Cal == 0)
+				{
+					/* checked before the offset moves the angles, CALSTEP_CALC takes d0Angle again */
+					valve.calibration.d0Angle = valve.pos.currentAngle + (int16_t)C_STOPPER_0D_ANGLE;
+					if (ValveQuickCalCheck(valve.calibration.d0Angle - valve.pos.modeAngle[C_MODE_B], valve.calibration.d0Angle) == 0u)
+					{
+						valve.calibration.req2Cal = 1; /* full sweep: on to the 360d stopper */
+					}
+				}
+#endif
 				if (valve.calibration.offsetDone == 0)
 				{
 					calcSensorOffset(valve.pos.currentAngle);
@@ -537,14 +828,49 @@ static tValveState ValveCalibrationTask(void)
 				else
 				{
 				}
+#if QUICK_CALIBRATION_ENABLE == 1
+				if (valve.calibration.req2Cal == 0)
+				{
+					diff = ValveCalWrap(valve.calibration.d360Angle - valve.memory.travel);
+					if (ValveQuickCalCheck(valve.calibration.d360Angle - ValveCalWrap(valve.pos.modeAngle[C_MODE_B] + valve.memory.travel), diff) != 0u)
+					{
+						valve.pos.modeAngle[C_MODE_A] = valve.calibration.d360Angle;
+						valve.pos.modeAngle[C_MODE_B] = diff;
+						ValveTargetAngleUpdate(valve.pos.modeAngle[C_MODE_B]); /* move to init position */
+						valve.calibration.state = CALSTEP_INIT_POS;
+					}
+					else
+					{
+						valve.calibration.req2Cal = 1; /* full sweep: 0d stopper, then this one again */
+						ValveTargetAngleUpdate(C_VALVE_CAL_0D_TARGET); /* move to 0% position */
+						valve.calibration.timer = 0;
+						valve.calibration.state = CALSTEP_0d_POS;
+					}
+				}
+				else
+				{
+#if GMR_HARMONIC_ENABLE == 1
+					gmr_harm_Done();
+#endif
+					valve.calibration.travel = valve.calibration.d360Angle - valve.calibration.d0Angle;
+					valve.pos.modeAngle[C_MODE_A] = valve.calibration.d360Angle;
+					ValveTargetAngleUpdate(valve.pos.modeAngle[C_MODE_B]); /* move to init position */
+					valve.calibration.state = CALSTEP_INIT_POS;
+				}
+#else
+#if GMR_HARMONIC_ENABLE == 1
+				gmr_harm_Done();
+#endif
 				valve.calibration.travel = valve.calibration.d360Angle - valve.calibration.d0Angle;
 #if 1
 				valve.pos.modeAngle[C_MODE_A] = valve.calibration.d360Angle;
 #endif
 				ValveTargetAngleUpdate(valve.pos.modeAngle[C_MODE_B]); /* move to init position */
+				valve.calibration.state = CALSTEP_INIT_POS;
+#endif
+				MotMeasureBacklash(); /* the gears are loaded against the 360d stopper */
 				MotSetTargetPosition(valve.pos.targetAngle);
 				valve.calibration.delay = 3;
-				valve.calibration.state = CALSTEP_INIT_POS;
 			}
 			else if (valve.motorMotion == MOTION_STOPPED)
 			{
@@ -579,13 +905,20 @@ static tValveState ValveCalibrationTask(void)
 			{
 				ValveTargetAngleUpdate(370 * C_GMR_ANGLE_SCALE_FACTOR); /* move to 360% position */
 				valve.calibration.state = CALSTEP_360d_POS;
+#if GMR_HARMONIC_ENABLE == 1
+				gmr_harm_Start();
+#endif
 			}
 			else
 			{
+#if QUICK_CALIBRATION_ENABLE == 1
+				valve.pos.modeAngle[C_MODE_A] = ValveCalWrap(valve.calibration.d0Angle + valve.memory.travel);
+#endif
 				ValveTargetAngleUpdate(valve.pos.modeAngle[C_MODE_B]); /* move to init position */
 				valve.calibration.state = CALSTEP_INIT_POS;
 			}
 			MotClearHardStop();
+			MotMeasureBacklash(); /* the gears are loaded against the 0d stopper */
 			MotSetTargetPosition(valve.pos.targetAngle);
 		}
 		break;
@@ -614,6 +947,7 @@ static tValveState ValveCalibrationTask(void)
 
 	case CALSTEP_FAULT:
 
+		MotSetEndStopConfirm(0u);
 		valve.calibration.req2Cal = 0;
 		valve.calibration.req1Cal = 0;
 		valve.diag.calFault = 1;
@@ -624,6 +958,13 @@ static tValveState ValveCalibrationTask(void)
 		break;
 	case CALSTEP_COMPLETED:
 
+		MotSetEndStopConfirm(0u);
+		valve.memory.backlash = MotGetBacklash();
+		if ((valve.calibration.req2Cal != 0) && (ValveTravelValid(valve.calibration.travel) != 0u))
+		{
+			valve.memory.travel = valve.calibration.travel;
+		}
+		ValveStoreCalRecord();
 		valve.calibration.req2Cal = 0;
 		valve.calibration.req1Cal = 0;
 		nextState = VALVE_STANDBY;
@@ -993,7 +1334,7 @@ static tValveState ValveDiagRunTask(void)
 	else
 	{
 		/* B->A->B*/
-		if ((valve.motorMotion >= MOTION_ACC) && (valve.motorMotion <= MOTION_DEC))
+		if ((valve.motorMotion >= MOTION_ACC) && (valve.motorMotion <= MOTION_FINE))
 		{
 			valve.elapsedTime = 0;
 		}
@@ -1451,6 +1792,13 @@ static void valveDiagSensor(void)
 	{
 		valve.diag.gmr.count = 0;
 	}
+#if GMR_PLAUSIBILITY_ENABLE == 1
+	/* open/shorted bridge leg or implausible sine/cosine, debounced within a ms */
+	if (get_gmr_fault() != 0u)
+	{
+		valve.diag.gmr.state = 1;
+	}
+#endif
 }
 static void valveDiagMcu(void)
 {
@@ -1919,6 +2267,10 @@ void AppValveInit(void)
 	valve.state = VALVE_INIT;
 	valve.lastState = VALVE_INIT;
 	valve.elapsedTime = 0;
+	valve.hold.armed = 0u;
+	valve.hold.retries = 0u;
+	valve.hold.quiet = 0u;
+	valve.memory.bootCheck = 0u;
 	valve.sleepState = 0;
 	valve.initStatus = 0;
 	valve.linLiveTimeOut = 4000;
@@ -1991,6 +2343,42 @@ void AppValveInit(void)
 	else
 	{
 	}
+	if (eeprom_ReadCalRecord(&valve.memory.record) && (valve.memory.record.gmrOffset > 0) &&
+		(valve.memory.record.gmrOffset <= (int16_t)C_GMR_SENSOR_ANGLE_LIMIT) &&
+		(ValveTravelValid(valve.memory.record.d360Angle - valve.memory.record.d0Angle) != 0u))
+	{
+		gmr_correction_t corr;
+
+		valve.memory.recordValid = 1u;
+		set_gmr_sensor_offset(valve.memory.record.gmrOffset);
+		valve.pos.modeAngle[C_MODE_B] = valve.memory.record.d0Angle;
+		valve.pos.modeAngle[C_MODE_A] = valve.memory.record.d360Angle;
+		valve.memory.travel = valve.memory.record.travel;
+		valve.memory.backlash = valve.memory.record.backlash;
+		corr.sinOffset = valve.memory.record.sinOffset;
+		corr.cosOffset = valve.memory.record.cosOffset;
+		corr.sinAmplitude = valve.memory.record.sinAmplitude;
+		corr.cosAmplitude = valve.memory.record.cosAmplitude;
+		corr.quadrature = valve.memory.record.quadrature;
+		corr.harmCos = valve.memory.record.harmCos;
+		corr.harmSin = valve.memory.record.harmSin;
+		set_gmr_correction(&corr);
+	}
+	else
+	{
+		/* no record yet: the values of the former single pages */
+		valve.memory.recordValid = 0u;
+		valve.memory.record.generation = 0u;
+		if (eeprom_ReadBacklash(&valve.memory.backlash) == false)
+		{
+			valve.memory.backlash = -1;
+		}
+		if (eeprom_ReadTravel(&valve.memory.travel) == false)
+		{
+			valve.memory.travel = 0;
+		}
+	}
+	MotSetBacklash(valve.memory.backlash);
 }
 /**
  * \brief Actuator task called by every 1ms
@@ -2001,6 +2389,9 @@ void AppValveTask(void)
 {
 	tValveState nextState = valve.state;
 	uint16_t protect_mode = 0, fault_err = 0;
+#if GMR_FIT_ENABLE == 1
+	uint8_t moved;
+#endif
 
 #if 0
 #if LIN_DEBUG_ENABLE
@@ -2050,7 +2441,10 @@ void AppValveTask(void)
 
 	valve.pos.currentAngle = MotGetCurrentPosition();
 	calc_PosToLinData(valve.pos.currentAngle);
-	if ((valve.motorMotion >= MOTION_ACC) && (valve.motorMotion <= MOTION_DEC))
+#if GMR_FIT_ENABLE == 1
+	moved = valve.comm.moving;
+#endif
+	if ((valve.motorMotion >= MOTION_ACC) && (valve.motorMotion <= MOTION_FINE))
 	{
 		valve.comm.moving = 1;
 	}
@@ -2058,6 +2452,28 @@ void AppValveTask(void)
 	{
 		valve.comm.moving = 0;
 	}
+#if GMR_FIT_ENABLE == 1
+	if (valve.comm.moving != 0)
+	{
+		gmr_fit_Update(valve.pos.currentAngle);
+	}
+	else if ((moved != 0) && (valve.state != VALVE_CALIBRATION))
+	{
+		gmr_fit_Track(); /* end of a move */
+	}
+	else
+	{
+	}
+	(void)gmr_fit_Task(); /* one step of the fit started at the end of a move */
+#endif
+#if GMR_HARMONIC_ENABLE == 1
+	/* full sweep to the 360d stopper, between the mode angles */
+	if ((valve.state == VALVE_CALIBRATION) && (valve.calibration.state == CALSTEP_360d_POS) && (valve.calibration.req2Cal != 0) &&
+		(valve.pos.currentAngle > valve.pos.modeAngle[C_MODE_B]) && (valve.pos.currentAngle < valve.pos.modeAngle[C_MODE_A]))
+	{
+		gmr_harm_Update(valve.pos.currentAngle, (uint8_t)(valve.motorMotion == MOTION_RUNNING));
+	}
+#endif
 	switch (valve.state)
 	{
 	case VALVE_INIT:
@@ -18,6 +18,22 @@
 #define CALSTEP_INIT_POS 7
 #define CALSTEP_FAULT 8
 #define CALSTEP_COMPLETED 9
+#define C_VALVE_CAL_ENDSTOP_CONFIRM 20u /* end-stop confirmation time of the calibration [ms] */
+
+/* quick calibration: one end stop, the other end from the travel of the last full calibration */
+#define C_VALVE_CAL_TRAVEL (90.0f * C_GMR_ANGLE_SCALE_FACTOR)	  /* nominal Mode A minus Mode B angle [0.1deg] */
+#define C_VALVE_CAL_TRAVEL_TOL (5.0f * C_GMR_ANGLE_SCALE_FACTOR) /* accepted deviation of a measured travel [0.1deg] */
+#define C_VALVE_QUICKCAL_WINDOW C_VALVE_ACCURACY_ANGLE			  /* touched end stop vs. the stored calibration [0.1deg] */
+#define C_VALVE_BOOT_WINDOW (5.0f * C_GMR_ANGLE_SCALE_FACTOR)	  /* angle at power on vs. the last power off with a calibration record [0.1deg] */
+#define C_VALVE_CAL_0D_TARGET (int16_t)(-10 * (int16_t)C_GMR_ANGLE_SCALE_FACTOR) /* target beyond the 0% end stop of the fallback sweep [0.1deg] */
+
+/* position hold: drift watchdog in standby */
+#define C_VALVE_HOLD_WINDOW C_VALVE_ACCURACY_ANGLE /* drift that is corrected [0.1deg] */
+#define C_VALVE_HOLD_SETTLE_MS 200u /* standby time before the first sample [ms] */
+#define C_VALVE_HOLD_SAMPLE_MS 20u	/* sample period [ms] */
+#define C_VALVE_HOLD_CONFIRM 3u		/* samples off the target in a row that start a correction */
+#define C_VALVE_HOLD_RETRIES 3u		/* corrections without a quiet time in between, then the hold gives up with a position fault */
+#define C_VALVE_HOLD_QUIET_MS 2000u /* time in the window that resets the corrections [ms] */
 
 /*scale: 0.01V */
 #define VS_UNDER_STOP (uint16_t)(8.0f * C_VOLTAGE_RESOLUTION_SCALE)	  //
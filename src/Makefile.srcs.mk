@@ -36,6 +36,7 @@ SRCS_APP += AppLin.c
 SRCS_APP += dcm_driver.c
 SRCS_APP += app_sensor.c
 SRCS_APP += uart.c
+SRCS_APP += profiler.c
 #
 # EXTRA PLATFORM MODULES TO COMPILE IN
 #
@@ -55,6 +56,7 @@ APP_MODULES += user_startup
 PLTF_LIBS += $(PRODUCT)
 PLTF_LIBS += buffers
 PLTF_LIBS += math
+PLTF_LIBS += fast_math
 PLTF_LIBS += mlx_lin_api
 
 #
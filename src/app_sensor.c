@@ -7,6 +7,7 @@
 /* platform */
 #include <stdint.h>
 #include <stdbool.h>
+#include <stddef.h>
 #include <plib.h>
 #include <itc_helper.h>
 #include <sys_tools.h>
@@ -15,6 +16,7 @@
 // #include <filter_lpf.h>
 #include <filter_avg.h>
 #include <conv_shunt_current.h>
+#include <dsp.h>
 // #include <mathlib.h>
 /* application */
 #include "defines.h"
@@ -22,26 +24,82 @@
 #include "app_sensor.h"
 #include "dcm_driver.h"
 
+/* atan2 kernel of calculate_gmr_angle(), see host/host_atan2_bench.c (make -C host bench)
+ *
+ *  kernel                      function                              max error  instructions
+ *  C_GMR_ATAN2_MATHLIB         atan2I16() (libmath)                  0.007 deg  41
+ *  C_GMR_ATAN2_FM_LUT          fm_Atan2I16DirectLutInlined()         0.114 deg  19
+ *  C_GMR_ATAN2_FM_INTERP       fm_Atan2I16InterpolationInlined()     0.006 deg  26
+ *  C_GMR_ATAN2_FM_INTERP_CALL  fm_Atan2I16InterpolationNonInlined()  0.006 deg  28
+ *
+ * The fast math kernels need libfast_math.a and its 516 byte LUT.
+ */
+#define C_GMR_ATAN2_MATHLIB 0u
+#define C_GMR_ATAN2_FM_LUT 1u
+#define C_GMR_ATAN2_FM_INTERP 2u
+#define C_GMR_ATAN2_FM_INTERP_CALL 3u
+#define GMR_ATAN2_KERNEL C_GMR_ATAN2_MATHLIB
+
+#if GMR_ATAN2_KERNEL != C_GMR_ATAN2_MATHLIB
+#include <fm_atan2.h>
+#endif
+
 static uint16_t l_au16MotorOffsetCurrent;
+/* filter of the current and GMR channels, see host/host_filter_bench.c (make -C host filter_bench)
+ *  C_ADC_FILTER_MOVAVG  8 sample moving average, FILTER_AVG_CalcBank()
+ *  C_ADC_FILTER_EXP     exponential average, time constant 8 samples, FILTER_AVG_CalcBankExp()
+ */
+#define C_ADC_FILTER_MOVAVG 0u
+#define C_ADC_FILTER_EXP 1u
+#define ADC_FAST_FILTER C_ADC_FILTER_MOVAVG
+
+#define C_ADC_NR_OF_SLOW C_ADC_CURRENT_					 /* channels of l_sAdcAvgObject[] */
+#define C_ADC_NR_OF_FAST (C_ADC_END_ITEM - C_ADC_CURRENT_) /* channels of l_sAdcFastBank */
+
 static uint16_t l_au16SupplyAvgBuffer[8u];		/**< supply voltage filter (buffer) */
 static uint16_t l_au16TemperatureAvgBuffer[8u]; /**< Temperature filter (buffer) */
-static uint16_t l_au16CurrentAvgBuffer[8u];		/**< Motor current filter (buffer) */
 static uint16_t l_au16VddaAvgBuffer[8u];		/**< Vdda filter (buffer) */
 static uint16_t l_au16IgnitionAvgBuffer[8u];	/**< supply voltage filter (buffer) */
-static uint16_t l_au16GmrIO1AvgBuffer[8u];		/**  */
-static uint16_t l_au16GmrIO2AvgBuffer[8u];		/** */
-static uint16_t l_au16GmrIO3AvgBuffer[8u];		/**  */
-static uint16_t l_au16GmrIO4AvgBuffer[8u];		/** */
-static FILTER_AVG_Object_t l_sAdcAvgObject[] = {
+static FILTER_AVG_Object_t l_sAdcAvgObject[C_ADC_NR_OF_SLOW] = {
 	{0u, 0u, &l_au16SupplyAvgBuffer[0], 8u, 0u},
 	{0u, 0u, &l_au16TemperatureAvgBuffer[0], 8u, 0u},
-	{0u, 0u, &l_au16CurrentAvgBuffer[0], 8u, 0u},
 	{0u, 0u, &l_au16VddaAvgBuffer[0], 8u, 0u},
-	{0u, 0u, &l_au16IgnitionAvgBuffer[0], 8u, 0u},
-	{0u, 0u, &l_au16GmrIO1AvgBuffer[0], 8u, 0u},
-	{0u, 0u, &l_au16GmrIO2AvgBuffer[0], 8u, 0u},
-	{0u, 0u, &l_au16GmrIO3AvgBuffer[0], 8u, 0u},
-	{0u, 0u, &l_au16GmrIO4AvgBuffer[0], 8u, 0u}};
+	{0u, 0u, &l_au16IgnitionAvgBuffer[0], 8u, 0u}};
+
+/* motor current and GMR 1..4, updated together every 100us */
+static uint16_t l_au16AdcFastAvg[C_ADC_NR_OF_FAST];	   /**< filter output per channel */
+static uint32_t l_au32AdcFastAvgxN[C_ADC_NR_OF_FAST];   /**< filter state per channel */
+#if ADC_FAST_FILTER == C_ADC_FILTER_MOVAVG
+static uint16_t l_au16AdcFastBuffer[8u * C_ADC_NR_OF_FAST]; /**< filter (buffer) */
+#define ADC_FAST_BUFFER &l_au16AdcFastBuffer[0]
+#else
+#define ADC_FAST_BUFFER NULL
+#endif
+static FILTER_AVG_Bank_t l_sAdcFastBank = {
+	&l_au16AdcFastAvg[0], &l_au32AdcFastAvgxN[0], ADC_FAST_BUFFER, C_ADC_NR_OF_FAST, 8u, 0u, 0u, 0u};
+
+/* acquisition rate of a slow channel, in calls of adc_raw_update() (100us) */
+#define C_ADC_RATE_1MS 10u
+#define C_ADC_RATE_10MS 100u
+
+typedef struct
+{
+	uint16_t (*fGetRaw)(void); /**< raw sample getter */
+	uint8_t u8Period;		   /**< update period [100us] */
+	uint8_t u8Phase;		   /**< first update [100us], spreads the slow channels over the ticks */
+} AdcChannel_t;
+
+/* slow channel table of adc_raw_update(), indexed like l_sAdcAvgObject[]
+ * The current and GMR channels feed the 100us control loop and are updated every call,
+ * supply and ignition are read by the 1ms application and the chip temperature and Vdda
+ * drift slowly. The moving averages keep 8 samples, so the filter window is 8x the
+ * update period. */
+static const AdcChannel_t l_asAdcChannel[C_ADC_NR_OF_SLOW] = {
+	{adc_GetRawVs, C_ADC_RATE_1MS, 0u},			   /* C_ADC_VS_ */
+	{adc_GetRawTemperature, C_ADC_RATE_10MS, 2u},  /* C_ADC_TEMP_ */
+	{adc_GetRawVdda, C_ADC_RATE_10MS, 7u},		   /* C_ADC_VDDA */
+	{adc_GetRawIGN, C_ADC_RATE_1MS, 5u}};		   /* C_ADC_IGN */
+static uint8_t l_au8AdcCountdown[C_ADC_NR_OF_SLOW]; /**< calls until the next update of a channel */
 
 int16_t l16_GmrCalEnable = 0;
 int16_t l16_SinPosMaxPeak;
@@ -54,12 +112,103 @@ int16_t l16_CosinNegMaxPeak;
 int16_t l16_CosinNegMinPeak;
 int16_t l16_SinOutputOffset;
 int16_t l16_CosinOutputOffset;
+int16_t l16_SinAmplitude;
+int16_t l16_CosinAmplitude;
+int16_t l16_GmrQuadrature;
+int16_t l16_GmrHarmCos;
+int16_t l16_GmrHarmSin;
 int16_t l16_SetGmrSensorOffset = 0;
+static int16_t l_i16GmrCosGain = C_GMR_GAIN_ONE; /**< cosine output gain matching the sine amplitude [Q14] */
+
+/* GMR bridge estimator, see gmr_fit_Update()
+ * The moments are averaged over the samples since the start, later over about
+ * 2^C_GMR_FIT_SHIFT samples. */
+#define C_GMR_FIT_SHIFT 12u
+#define C_GMR_FIT_SECTOR 225u		/* coverage sector [0.1deg] */
+#define C_GMR_FIT_RADIUS_MAX 15565	/* squared radius of a sample used, 1.9 [Q13] */
+#define C_GMR_FIT_PIVOT_MIN 16384	/* smallest pivot of the centre terms, 2^-12 [Q26] */
+#define C_GMR_FIT_PIVOT_MISMATCH 131072 /* smallest pivot of the mismatch terms, 2^-9 [Q26] */
+#define C_GMR_FIT_NR_OF_TERMS 4u	/* c, s, c^2 - s^2, 2cs; the squared radius is the fifth feature */
+#define C_GMR_SOLVE_IDLE 0u
+#define C_GMR_SOLVE_ELIMINATE 1u
+#define C_GMR_SOLVE_SUBSTITUTE 2u
+#define C_GMR_SOLVE_DONE 3u
+/* solve of the normal equations, one division at a time, see gmr_fit_solve_step() */
+typedef struct
+{
+	int32_t x[C_GMR_FIT_NR_OF_TERMS]; /**< solution [Q24], C_GMR_SOLVE_DONE only */
+	uint8_t row;	/**< pivot row of the elimination, then the row substituted */
+	uint8_t col;	/**< column reduced below the pivot */
+	uint8_t terms;	/**< terms eliminated */
+	uint8_t state;	/**< C_GMR_SOLVE_xxx */
+} gmr_solve_t;
+typedef struct
+{
+	int32_t mean[C_GMR_FIT_NR_OF_TERMS + 1u];					/**< feature means [Q28] */
+	int32_t cov[C_GMR_FIT_NR_OF_TERMS][C_GMR_FIT_NR_OF_TERMS + 1u]; /**< feature covariances, upper triangle and squared radius column [Q26] */
+	int16_t radius;		/**< normalisation of the outputs, the sine amplitude in use [LSB], 0: not known yet */
+	uint16_t samples;	/**< samples since the start, saturating */
+	uint16_t sectors;	/**< C_GMR_FIT_SECTOR sectors of the sensor angle seen, one bit each */
+	uint8_t shift;		/**< averaging of the current sample, log2(samples) up to C_GMR_FIT_SHIFT */
+	gmr_solve_t solve;	/**< fit of the covariances, started by gmr_fit_Track() */
+} gmr_fit_t;
+static gmr_fit_t l_sGmrFit;
+static const int32_t l_ai32GmrFitPivot[C_GMR_FIT_NR_OF_TERMS] = {C_GMR_FIT_PIVOT_MIN, C_GMR_FIT_PIVOT_MIN,
+																C_GMR_FIT_PIVOT_MISMATCH, C_GMR_FIT_PIVOT_MISMATCH};
+
+#if GMR_HARMONIC_ENABLE == 1
+/* 4th harmonic angle error, see gmr_harm_Update()
+ * The error harmCos cos(4a) + harmSin sin(4a) of the raw sensor angle a repeats every 90deg,
+ * the table holds one period. */
+#define C_GMR_HARM_LUT_SIZE 64u
+#define C_GMR_HARM_TIME_MAX 4095u	   /* samples of a sweep taken from its start [1ms] */
+#define C_GMR_HARM_MIN_SAMPLES 256u	   /* samples of a sweep before an estimate is used [1ms] */
+#define C_GMR_HARM_PIVOT_TREND 256	   /* smallest pivot of the time terms [Q26] */
+#define C_GMR_HARM_PIVOT_MIN 4194304   /* smallest pivot of the harmonic terms, 1/16 [Q26] */
+#define C_GMR_HARM_OFF 0u
+#define C_GMR_HARM_LEARN 1u
+#define C_GMR_HARM_DONE 2u
+typedef struct
+{
+	int32_t mean[C_GMR_FIT_NR_OF_TERMS + 1u];					/**< feature means [Q28] */
+	int32_t cov[C_GMR_FIT_NR_OF_TERMS][C_GMR_FIT_NR_OF_TERMS + 1u]; /**< feature covariances, upper triangle and angle column [Q26] */
+	int16_t first;		/**< angle of the first sample [0.1deg] */
+	int16_t harmCos;	/**< estimate, C_GMR_HARM_DONE only [0.01deg] */
+	int16_t harmSin;
+	uint16_t time;		/**< since the first sample [1ms] */
+	uint16_t samples;	/**< samples taken */
+	uint8_t shift;		/**< averaging of the current sample, log2(samples) up to C_GMR_FIT_SHIFT */
+	uint8_t state;		/**< C_GMR_HARM_OFF, C_GMR_HARM_LEARN or C_GMR_HARM_DONE */
+} gmr_harm_t;
+static gmr_harm_t l_sGmrHarm;
+static const int32_t l_ai32GmrHarmPivot[C_GMR_FIT_NR_OF_TERMS] = {C_GMR_HARM_PIVOT_MIN, C_GMR_HARM_PIVOT_MIN,
+																 C_GMR_HARM_PIVOT_TREND, C_GMR_HARM_PIVOT_TREND};
+/* sin(k pi / 32) [Q13], a quarter period */
+static const int16_t l_ai16GmrHarmSine[17] = {0, 803, 1598, 2378, 3135, 3862, 4551, 5197, 5793,
+											  6333, 6811, 7225, 7568, 7839, 8035, 8153, 8192};
+static int8_t l_ai8GmrHarmLut[C_GMR_HARM_LUT_SIZE]; /**< angle error over one period of 4a [0.01deg] */
+static uint16_t l_u16GmrAngleRaw;					/**< atan2 of the last angle [2pi / 65536] */
+#endif
+
+#if GMR_PLAUSIBILITY_ENABLE == 1
+/* bridge output plausibility, see gmr_plausibility_check() */
+#define C_GMR_FAULT_NR_OF_CHECKS 6u /* bits of the fault word */
+#define C_GMR_FAULT_SETTLE 8u		/* samples until the filter of the bridge legs is filled [100us] */
+static uint8_t l_au8GmrFaultCount[C_GMR_FAULT_NR_OF_CHECKS]; /**< debounce counter per check */
+static uint8_t l_u8GmrFaultSettle;							 /**< samples left until the checks start */
+static uint8_t l_u8GmrFault;								 /**< debounced fault word, C_GMR_FAULT_xxx */
+#endif
+
+/* multi-turn angle tracker */
+static int32_t l_i32GmrAngleUnwrapped = 0; /**< continuous angle [0.1deg] */
+static int16_t l_i16GmrAngleLast = 0;	   /**< last wrapped angle [0.1deg] */
+static int16_t l_i16GmrTurns = 0;		   /**< revolutions of the continuous angle */
+static uint8_t l_u8GmrTrackInit = 0u;	   /**< 0: seed the tracker with the next angle */
 void sensor_init(void)
 {
 	uint16_t num = 0, index = 0, initValue;
 
-	for (num = 0; num < C_ADC_END_ITEM; num++)
+	for (num = 0; num < C_ADC_NR_OF_SLOW; num++)
 	{
 		if (num == C_ADC_VS_)
 			initValue = 0xFF;
@@ -73,11 +222,352 @@ void sensor_init(void)
 			l_sAdcAvgObject[num].pu16Raw[index] = initValue;
 			l_sAdcAvgObject[num].u32MovAvgxN += initValue;
 		}
+		l_au8AdcCountdown[num] = l_asAdcChannel[num].u8Phase + 1u;
 	}
+	(void)FILTER_AVG_InitBank(&l_sAdcFastBank);
 	gmr_calibration_setup();
 	//	l16_SetGmrSensorOffset=C_GMR_SENSOR_OFFSET*C_GMR_ANGLE_SCALE_FACTOR;
 	l16_SetGmrSensorOffset = (DEFAULT_GMR_OFFSET * C_GMR_ANGLE_SCALE_FACTOR);
 	l_au16MotorOffsetCurrent = 0;
+	gmr_angle_track_reset();
+#if GMR_PLAUSIBILITY_ENABLE == 1
+	for (index = 0; index < C_GMR_FAULT_NR_OF_CHECKS; index++)
+	{
+		l_au8GmrFaultCount[index] = 0u;
+	}
+	l_u8GmrFaultSettle = C_GMR_FAULT_SETTLE;
+	l_u8GmrFault = 0u;
+#endif
+}
+static int16_t gmr_abs_diff(int16_t a, int16_t b)
+{
+	int16_t diff = a - b;
+
+	return (diff < 0) ? -diff : diff;
+}
+static int32_t gmr_fit_limit(int32_t value, int32_t limit)
+{
+	if (value > limit)
+	{
+		value = limit;
+	}
+	else if (value < -limit)
+	{
+		value = -limit;
+	}
+	else
+	{
+	}
+	return value;
+}
+#if GMR_HARMONIC_ENABLE == 1
+/* sin(phase) [Q13], phase [2pi / 65536] */
+static int16_t gmr_harm_sin(uint16_t phase)
+{
+	uint16_t k = (phase >> 10) & 15u;
+	int16_t y0, y1;
+
+	if ((phase & 0x4000u) != 0u)
+	{
+		y0 = l_ai16GmrHarmSine[16u - k];
+		y1 = l_ai16GmrHarmSine[15u - k];
+	}
+	else
+	{
+		y0 = l_ai16GmrHarmSine[k];
+		y1 = l_ai16GmrHarmSine[k + 1u];
+	}
+	y0 += (int16_t)(((int32_t)(y1 - y0) * (int16_t)((phase >> 2) & 0xFFu)) >> 8);
+	return ((phase & 0x8000u) != 0u) ? -y0 : y0;
+}
+/* 4th harmonic angle error at the atan2 result raw [0.1deg], a table lookup and interpolation */
+static int16_t gmr_harm_error(uint16_t raw)
+{
+	uint16_t phase = (uint16_t)(raw << 2);
+	uint16_t i = phase >> 10;
+	int16_t e0 = l_ai8GmrHarmLut[i];
+	int16_t e1 = l_ai8GmrHarmLut[(i + 1u) & (C_GMR_HARM_LUT_SIZE - 1u)];
+	int32_t e = ((int32_t)e0 << 8) + ((int32_t)(e1 - e0) * (int16_t)((phase >> 2) & 0xFFu));
+
+	return (int16_t)(((e * 205) + 0x40000) >> 19); /* [0.01deg / 256] -> [0.1deg] */
+}
+#endif
+/* use the 4th harmonic coefficients, the table is built from them */
+static void gmr_harm_load(int16_t harmCos, int16_t harmSin)
+{
+#if GMR_HARMONIC_ENABLE == 1
+	uint16_t i, phase;
+	int32_t e;
+
+	for (i = 0u; i < C_GMR_HARM_LUT_SIZE; i++)
+	{
+		phase = (uint16_t)(i << 10);
+		e = ((int32_t)harmCos * gmr_harm_sin(phase + 0x4000u)) + ((int32_t)harmSin * gmr_harm_sin(phase));
+		l_ai8GmrHarmLut[i] = (int8_t)gmr_fit_limit((e + 4096) >> 13, 127);
+	}
+#endif
+	l16_GmrHarmCos = harmCos;
+	l16_GmrHarmSin = harmSin;
+}
+static void gmr_correction_load(const gmr_correction_t *corr)
+{
+	l16_SinOutputOffset = corr->sinOffset;
+	l16_CosinOutputOffset = corr->cosOffset;
+	l16_SinAmplitude = corr->sinAmplitude;
+	l16_CosinAmplitude = corr->cosAmplitude;
+	l16_GmrQuadrature = corr->quadrature;
+	gmr_harm_load(corr->harmCos, corr->harmSin);
+	if ((corr->sinAmplitude > 0) && (corr->cosAmplitude > 0))
+	{
+		l_i16GmrCosGain = (int16_t)(((int32_t)corr->sinAmplitude << 14) / corr->cosAmplitude);
+	}
+	else
+	{
+		l_i16GmrCosGain = C_GMR_GAIN_ONE;
+	}
+}
+/* restart the estimator from the correction in use */
+static void gmr_fit_reset(void)
+{
+	gmr_fit_t *fit = &l_sGmrFit;
+	uint16_t i, j;
+
+	for (i = 0u; i <= C_GMR_FIT_NR_OF_TERMS; i++)
+	{
+		fit->mean[i] = 0;
+	}
+	for (i = 0u; i < C_GMR_FIT_NR_OF_TERMS; i++)
+	{
+		for (j = 0u; j <= C_GMR_FIT_NR_OF_TERMS; j++)
+		{
+			fit->cov[i][j] = 0;
+		}
+	}
+	fit->radius = l16_SinAmplitude;
+	fit->samples = 0u;
+	fit->sectors = 0u;
+	fit->shift = 0u;
+	fit->solve.state = C_GMR_SOLVE_IDLE;
+}
+/* 1: enough samples over enough of the circle */
+static uint8_t gmr_fit_converged(void)
+{
+	uint16_t sectors = l_sGmrFit.sectors;
+	uint16_t count = 0u;
+
+	while (sectors != 0u)
+	{
+		count += (sectors & 1u);
+		sectors >>= 1;
+	}
+	return (uint8_t)((l_sGmrFit.samples >= C_GMR_FIT_MIN_SAMPLES) && (count >= C_GMR_FIT_MIN_BINS));
+}
+/* (a * b) >> 24 from 16 bit products, the result must fit in 31 bits */
+static int32_t gmr_fit_mul(int32_t a, int32_t b)
+{
+	uint32_t ua = (a < 0) ? (uint32_t)-a : (uint32_t)a;
+	uint32_t ub = (b < 0) ? (uint32_t)-b : (uint32_t)b;
+	uint32_t ah = ua >> 16, al = ua & 0xFFFFu;
+	uint32_t bh = ub >> 16, bl = ub & 0xFFFFu;
+	uint32_t p = ((ah * bh) << 8) + ((ah * bl) >> 8) + ((al * bh) >> 8) + ((al * bl) >> 24);
+
+	return ((a < 0) != (b < 0)) ? -(int32_t)p : (int32_t)p;
+}
+/* num / den [Q24], den positive below 2^28, limited to +/-8.0
+ * Restoring division, one quotient bit per shift and subtract: the MLX16 divides 32 by 16 bits
+ * only, a 32 bit divisor goes to the slow division of the runtime library. */
+static int32_t gmr_fit_div(int32_t num, int32_t den)
+{
+	uint32_t rem = (num < 0) ? (uint32_t)-num : (uint32_t)num;
+	uint32_t d = (uint32_t)den << 2;
+	uint32_t q = 0u;
+	uint16_t i;
+
+	if (rem >= (d << 1))
+	{
+		q = (8UL << 24) - 1u;
+	}
+	else
+	{
+		/* 3 integer and 24 fraction bits, the remainder stays below 8 den < 2^31 */
+		for (i = 0u; i < 27u; i++)
+		{
+			q <<= 1;
+			if (rem >= d)
+			{
+				rem -= d;
+				q |= 1u;
+			}
+			rem <<= 1;
+		}
+	}
+	return (num < 0) ? -(int32_t)q : (int32_t)q;
+}
+/* add the sample f to the running means [Q28] and covariances [Q26] of the features, averaged
+ * over 2^shift samples (Welford)
+ * round is added to the covariance updates, truncated they drift by 2^shift / 2 all alike,
+ * which the time terms of gmr_harm_Update() do not stand. */
+static void gmr_fit_accumulate(int32_t *mean, int32_t (*cov)[C_GMR_FIT_NR_OF_TERMS + 1u], int32_t *f, uint8_t shift, int32_t round)
+{
+	int16_t d[C_GMR_FIT_NR_OF_TERMS + 1u];
+	uint16_t i, j;
+
+	/* d from the means before, f from the means after the sample */
+	for (i = 0u; i <= C_GMR_FIT_NR_OF_TERMS; i++)
+	{
+		d[i] = (int16_t)(f[i] - ((mean[i] + 0x4000) >> 15));
+		mean[i] += ((int32_t)d[i] << 15) >> shift;
+		f[i] -= (mean[i] + 0x4000) >> 15;
+	}
+	for (i = 0u; i < C_GMR_FIT_NR_OF_TERMS; i++)
+	{
+		for (j = i; j <= C_GMR_FIT_NR_OF_TERMS; j++)
+		{
+			cov[i][j] += (((int32_t)d[i] * (int16_t)f[j]) - cov[i][j] + round) >> shift;
+		}
+	}
+}
+/* start the solve of the normal equations, the covariances a [Q26] with the right hand side in
+ * the last column, the lower triangle is filled from the upper one */
+static void gmr_fit_solve_start(gmr_solve_t *solve, int32_t (*a)[C_GMR_FIT_NR_OF_TERMS + 1u])
+{
+	uint16_t i, j;
+
+	for (i = 1u; i < C_GMR_FIT_NR_OF_TERMS; i++)
+	{
+		for (j = 0u; j < i; j++)
+		{
+			a[i][j] = a[j][i];
+		}
+	}
+	solve->row = 0u;
+	solve->col = 1u;
+	solve->terms = 0u;
+	solve->state = C_GMR_SOLVE_ELIMINATE;
+}
+/* one division of the solve, called until it returns 0, at most 16 times
+ * Gaussian elimination as long as the pivots stay above pivot[], one column of the rows below
+ * the pivot per call, then the back substitution of the first terms eliminated, one row per
+ * call. Without all terms eliminated only the first two are substituted, their rows do not
+ * depend on the later ones, the others are 0. Fewer than two give no solution.
+ * @return 1: more steps to go */
+static uint8_t gmr_fit_solve_step(gmr_solve_t *solve, int32_t (*a)[C_GMR_FIT_NR_OF_TERMS + 1u], const int32_t *pivot)
+{
+	int32_t t;
+	uint16_t i, j;
+	uint16_t k = solve->row;
+
+	if (solve->state == C_GMR_SOLVE_ELIMINATE)
+	{
+		if ((k < C_GMR_FIT_NR_OF_TERMS) && (a[k][k] >= pivot[k]))
+		{
+			j = solve->col;
+			t = gmr_fit_div(a[k][j], a[k][k]);
+			for (i = k + 1u; i < C_GMR_FIT_NR_OF_TERMS; i++)
+			{
+				a[i][j] -= gmr_fit_mul(a[i][k], t);
+			}
+			if (j < C_GMR_FIT_NR_OF_TERMS)
+			{
+				solve->col++;
+			}
+			else
+			{
+				solve->row++;
+				solve->col = solve->row + 1u;
+			}
+		}
+		else
+		{
+			solve->terms = (uint8_t)k;
+			if (k < C_GMR_FIT_NR_OF_TERMS)
+			{
+				k = (k < 2u) ? 0u : 2u;
+			}
+			for (i = k; i < C_GMR_FIT_NR_OF_TERMS; i++)
+			{
+				solve->x[i] = 0;
+			}
+			solve->row = (uint8_t)k;
+			solve->state = C_GMR_SOLVE_SUBSTITUTE;
+		}
+	}
+	else if ((solve->state == C_GMR_SOLVE_SUBSTITUTE) && (k > 0u))
+	{
+		k--;
+		t = a[k][C_GMR_FIT_NR_OF_TERMS];
+		for (j = k + 1u; j < C_GMR_FIT_NR_OF_TERMS; j++)
+		{
+			t -= gmr_fit_mul(a[k][j], solve->x[j]);
+		}
+		solve->x[k] = gmr_fit_limit(gmr_fit_div(t, a[k][k]), 0x1000000);
+		solve->row = (uint8_t)k;
+	}
+	else
+	{
+		solve->state = C_GMR_SOLVE_DONE;
+	}
+	return (uint8_t)(solve->state != C_GMR_SOLVE_DONE);
+}
+/* Give the correction the solved least squares fit finds, in the format of the calibration
+ * record. The solve uses up the covariances, the estimator must restart after it.
+ * The normalised outputs (c, s) of the correction in use satisfy
+ *   c^2 + s^2 = A c + B s + D (c^2 - s^2) + E 2cs + r^2
+ * The centre of the outputs is then at (A/2, B/2), the cosine gain is 1 + D too small and
+ * the quadrature E too small, all close to 0 as the fit starts from the correction in use.
+ * The covariances of the four terms form the normal equations of (A, B, D, E), the
+ * elimination runs in Q24/Q26 as the valve arc leaves the last pivot about 100 times
+ * smaller than the first. A move over part of the arc does not determine D and E, the fit
+ * then keeps the gain and quadrature in use and only gives the centre and amplitude.
+ * @return 0: the samples do not determine the fit */
+static uint8_t gmr_fit_estimate(gmr_correction_t *corr)
+{
+	const int32_t *mean = l_sGmrFit.mean;
+	const int32_t *x = l_sGmrFit.solve.x;
+	int32_t t, gain, quad, amp;
+	int16_t radius = l_sGmrFit.radius;
+	uint16_t i;
+
+	if ((l_sGmrFit.solve.state != C_GMR_SOLVE_DONE) || (l_sGmrFit.solve.terms < 2u))
+	{
+		return 0u;
+	}
+
+	/* r^2 from the means [Q28] */
+	t = mean[C_GMR_FIT_NR_OF_TERMS];
+	for (i = 0u; i < C_GMR_FIT_NR_OF_TERMS; i++)
+	{
+		t -= gmr_fit_mul(x[i], mean[i]);
+	}
+	/* radius * r, r close to 1 */
+	amp = radius + ((radius * gmr_fit_limit((t - 0x10000000) >> 13, 0x8000)) >> 16);
+	/* centre, the cosine also with the quadrature of the sine offset [LSB] */
+	t = (x[0] >> 9) * radius;
+	corr->sinOffset = (int16_t)gmr_fit_limit(l16_SinOutputOffset + ((t + 0x10000) >> 17), C_GMR_FIT_OFFSET_MAX);
+	t = ((x[1] >> 9) + (((x[0] >> 9) * l16_GmrQuadrature) >> 15)) * radius;
+	t = (((t + 0x10000) >> 17) << 14) / l_i16GmrCosGain;
+	corr->cosOffset = (int16_t)gmr_fit_limit(l16_CosinOutputOffset + t, C_GMR_FIT_OFFSET_MAX);
+	/* gain and quadrature, 1 + D and E on top of the ones in use */
+	gain = l_i16GmrCosGain + (((int32_t)l_i16GmrCosGain * (x[2] >> 10)) >> 14);
+	gain = C_GMR_GAIN_ONE + gmr_fit_limit(gain - C_GMR_GAIN_ONE, C_GMR_FIT_GAIN_RANGE);
+	quad = l16_GmrQuadrature + (x[3] >> 9) + (((int32_t)l16_GmrQuadrature * (x[2] >> 10)) >> 14);
+	corr->quadrature = (int16_t)gmr_fit_limit(quad, C_GMR_FIT_QUAD_MAX);
+	if (amp < C_GMR_FIT_AMP_MIN)
+	{
+		amp = C_GMR_FIT_AMP_MIN;
+	}
+	corr->sinAmplitude = (int16_t)gmr_fit_limit(amp, C_GMR_POSITIVE_MAX);
+	corr->cosAmplitude = (int16_t)(((int32_t)corr->sinAmplitude << 14) / gain);
+	corr->harmCos = l16_GmrHarmCos;
+	corr->harmSin = l16_GmrHarmSin;
+	return 1u;
+}
+/* cosine output with the amplitude mismatch and quadrature error removed */
+static int16_t gmr_cosine_correct(int16_t sine, int16_t cosine)
+{
+	int32_t cal = (((int32_t)cosine * l_i16GmrCosGain) >> 14) - (((int32_t)sine * l16_GmrQuadrature) >> 15);
+
+	return (int16_t)gmr_fit_limit(cal, C_GMR_POSITIVE_MAX);
 }
 void gmr_calibration_setup(void)
 {
@@ -92,6 +582,12 @@ void gmr_calibration_setup(void)
 	l16_CosinNegMinPeak = 0x7fff;
 	l16_SinOutputOffset = 0xFFFF;
 	l16_CosinOutputOffset = 1;
+	l16_SinAmplitude = 0;
+	l16_CosinAmplitude = 0;
+	l16_GmrQuadrature = 0;
+	l_i16GmrCosGain = C_GMR_GAIN_ONE;
+	gmr_harm_load(0, 0);
+	gmr_fit_reset();
 }
 void gmr_calibration_end(void)
 {
@@ -104,58 +600,339 @@ int16_t get_gmr_sensor_offset(void)
 {
 	return l16_SetGmrSensorOffset;
 }
+void get_gmr_correction(gmr_correction_t *corr)
+{
+	corr->sinOffset = l16_SinOutputOffset;
+	corr->cosOffset = l16_CosinOutputOffset;
+	corr->sinAmplitude = l16_SinAmplitude;
+	corr->cosAmplitude = l16_CosinAmplitude;
+	corr->quadrature = l16_GmrQuadrature;
+	corr->harmCos = l16_GmrHarmCos;
+	corr->harmSin = l16_GmrHarmSin;
+}
+/* use a correction and restart the estimator from it */
+void set_gmr_correction(const gmr_correction_t *corr)
+{
+	gmr_correction_load(corr);
+	gmr_fit_reset();
+}
+/* 1: a and b give angles that differ by more than about 0.45deg, or only one is measured
+ * The common amplitude does not change the angle, only its mismatch does. It is kept within
+ * 1/16 so that the estimator restarts close to it. */
+uint8_t gmr_correction_moved(const gmr_correction_t *a, const gmr_correction_t *b)
+{
+	int16_t tol = ((a->sinAmplitude > b->sinAmplitude) ? a->sinAmplitude : b->sinAmplitude) >> C_GMR_CORR_TOL_SHIFT;
+	uint8_t moved = 0u;
+
+	if (tol < 1)
+	{
+		tol = 1;
+	}
+	if (((a->sinAmplitude == 0) != (b->sinAmplitude == 0)) ||
+		(gmr_abs_diff(a->sinOffset, b->sinOffset) > tol) ||
+		(gmr_abs_diff(a->cosOffset, b->cosOffset) > tol) ||
+		(gmr_abs_diff(a->cosAmplitude - a->sinAmplitude, b->cosAmplitude - b->sinAmplitude) > tol) ||
+		(gmr_abs_diff(a->sinAmplitude, b->sinAmplitude) > (tol << (C_GMR_CORR_TOL_SHIFT - 4u))) ||
+		(gmr_abs_diff(a->quadrature, b->quadrature) > (int16_t)(0x8000u >> C_GMR_CORR_TOL_SHIFT)) ||
+		(gmr_abs_diff(a->harmCos, b->harmCos) > C_GMR_HARM_TOL) ||
+		(gmr_abs_diff(a->harmSin, b->harmSin) > C_GMR_HARM_TOL))
+	{
+		moved = 1u;
+	}
+	return moved;
+}
+/* Estimate the bridge offsets, amplitude mismatch and quadrature error, called every 1ms
+ * while the valve moves.
+ * The outputs as the angle sees them are normalised by the sine amplitude in use to (c, s)
+ * and the running means and covariances of c, s, c^2 - s^2, 2cs and c^2 + s^2 collected.
+ * gmr_fit_estimate() fits the conic of the bridge errors to them (least squares). The valve
+ * turns through about a third of the circle, all five terms are still determined, but only
+ * from the whole move. The estimate is not used by the angle until gmr_fit_Task() or
+ * gmr_fit_Apply(). The samples of a move while the fit is solved are left out.
+ * @param[in]  angle  sensor angle [0.1deg] */
+void gmr_fit_Update(int16_t angle)
+{
+	gmr_fit_t *fit = &l_sGmrFit;
+	int32_t f[C_GMR_FIT_NR_OF_TERMS + 1u];
+	int32_t x, y, c, s;
+
+	if (fit->solve.state != C_GMR_SOLVE_IDLE)
+	{
+		return;
+	}
+	x = get_gmr_sine_output();
+	y = gmr_cosine_correct((int16_t)x, get_gmr_cosine_output());
+	c = (x < 0) ? -x : x;
+	s = (y < 0) ? -y : y;
+	if (fit->radius == 0)
+	{
+		/* not measured yet, start from the magnitude of the first sample, max + min / 2 */
+		c = (c > s) ? (c + (s >> 1)) : (s + (c >> 1));
+		fit->radius = (int16_t)((c < C_GMR_FIT_AMP_MIN) ? C_GMR_FIT_AMP_MIN : c);
+		return;
+	}
+	/* normalised outputs [Q13], samples far off the circle are left out */
+	if ((c > (fit->radius + (fit->radius >> 1))) || (s > (fit->radius + (fit->radius >> 1))))
+	{
+		return;
+	}
+	c = (x << 13) / fit->radius;
+	s = (y << 13) / fit->radius;
+	f[0] = c;
+	f[1] = s;
+	f[2] = ((c * c) - (s * s) + 4096) >> 13;
+	f[3] = ((c * s) + 2048) >> 12;
+	f[C_GMR_FIT_NR_OF_TERMS] = ((c * c) + (s * s) + 4096) >> 13;
+	if (f[C_GMR_FIT_NR_OF_TERMS] > C_GMR_FIT_RADIUS_MAX)
+	{
+		return;
+	}
+
+	if (fit->samples < 0xFFFFu)
+	{
+		fit->samples++;
+	}
+	if ((fit->shift < C_GMR_FIT_SHIFT) && ((fit->samples >> (fit->shift + 1u)) != 0u))
+	{
+		fit->shift++;
+	}
+	gmr_fit_accumulate(fit->mean, fit->cov, f, fit->shift, 0);
+
+	if ((angle >= 0) && (angle < (int16_t)C_GMR_SENSOR_ANGLE_LIMIT))
+	{
+		fit->sectors |= (uint16_t)(1u << ((uint16_t)angle / C_GMR_FIT_SECTOR));
+	}
+}
+/* start the fit when the correction in use was measured, called at the end of a move
+ * The fit is solved by gmr_fit_Task(), one division per 1ms, the whole solve would hold up
+ * the 100us motor control for several slots. */
+void gmr_fit_Track(void)
+{
+	gmr_fit_t *fit = &l_sGmrFit;
+
+	if ((l16_SinAmplitude != 0) && (fit->solve.state == C_GMR_SOLVE_IDLE) && (gmr_fit_converged() != 0u))
+	{
+		gmr_fit_solve_start(&fit->solve, fit->cov);
+	}
+}
+/* one step of the fit started by gmr_fit_Track(), called every 1ms
+ * At the end of the solve the estimate is used, the angle then follows the bridge drift, over
+ * temperature and lifetime, with the mode angles of the last calibration still in place.
+ * Estimates within the noise of the fit, see gmr_correction_moved(), are not used.
+ * @return 1: estimate in use */
+uint8_t gmr_fit_Task(void)
+{
+	gmr_fit_t *fit = &l_sGmrFit;
+	gmr_correction_t active, corr;
+	uint8_t retval = 0u;
+
+	if ((fit->solve.state != C_GMR_SOLVE_IDLE) && (gmr_fit_solve_step(&fit->solve, fit->cov, l_ai32GmrFitPivot) == 0u))
+	{
+		get_gmr_correction(&active);
+		if ((gmr_fit_estimate(&corr) != 0u) && (gmr_correction_moved(&corr, &active) != 0u))
+		{
+			gmr_correction_load(&corr);
+			retval = 1u;
+		}
+		gmr_fit_reset();
+	}
+	return retval;
+}
+#if GMR_HARMONIC_ENABLE == 1
+/* restart the 4th harmonic fit, called at the start of a full calibration sweep
+ * A sweep with the bridge correction not measured yet is left out, its 1st and 2nd harmonic
+ * errors leak into the 4th over the short valve arc. */
+void gmr_harm_Start(void)
+{
+	gmr_harm_t *harm = &l_sGmrHarm;
+	uint16_t i, j;
+
+	for (i = 0u; i <= C_GMR_FIT_NR_OF_TERMS; i++)
+	{
+		harm->mean[i] = 0;
+	}
+	for (i = 0u; i < C_GMR_FIT_NR_OF_TERMS; i++)
+	{
+		for (j = 0u; j <= C_GMR_FIT_NR_OF_TERMS; j++)
+		{
+			harm->cov[i][j] = 0;
+		}
+	}
+	harm->time = 0u;
+	harm->samples = 0u;
+	harm->shift = 0u;
+	harm->state = (l16_SinAmplitude != 0) ? C_GMR_HARM_LEARN : C_GMR_HARM_OFF;
+}
+/* Collect the angle of a full calibration sweep for the 4th harmonic fit, called every 1ms
+ * between the end stops.
+ * The valve turns at roughly constant speed, so the angle follows a quadratic of the time up
+ * to the angle error. The running means and covariances of the time t, t^2, cos(4a) and
+ * sin(4a) of the raw sensor angle a, and of the angle are collected, gmr_harm_Done() fits
+ * them (least squares). The valve arc of about 130deg spans more than one period of the 4th
+ * harmonic, the 2nd harmonic is not determined by it apart from the time terms and is left
+ * to the bridge correction (gmr_fit_Update()).
+ * @param[in]  angle  sensor angle [0.1deg]
+ * @param[in]  use    1: steady motion, the sample is taken, 0: only the time runs on */
+void gmr_harm_Update(int16_t angle, uint8_t use)
+{
+	gmr_harm_t *harm = &l_sGmrHarm;
+	int32_t f[C_GMR_FIT_NR_OF_TERMS + 1u];
+	uint16_t phase;
+
+	if ((harm->state != C_GMR_HARM_LEARN) || ((harm->samples == 0u) && (use == 0u)))
+	{
+		return;
+	}
+	if (harm->samples == 0u)
+	{
+		harm->first = angle;
+	}
+	else if (harm->time <= C_GMR_HARM_TIME_MAX)
+	{
+		harm->time++;
+	}
+	else
+	{
+	}
+	if ((use == 0u) || (harm->time > C_GMR_HARM_TIME_MAX))
+	{
+		return;
+	}
+	/* the harmonic terms first, the time terms are small next to them and would leave
+	 * quotients beyond gmr_fit_div() in the elimination
+	 * time [Q13 of 1024ms], the angle relative to the first sample [0.1deg] */
+	phase = (uint16_t)(l_u16GmrAngleRaw << 2);
+	f[0] = gmr_harm_sin(phase + 0x4000u);
+	f[1] = gmr_harm_sin(phase);
+	f[2] = (int32_t)harm->time << 3;
+	f[3] = (f[2] * f[2]) >> 15;
+	f[C_GMR_FIT_NR_OF_TERMS] = angle - harm->first;
+	if (f[C_GMR_FIT_NR_OF_TERMS] >= (int16_t)(C_GMR_SENSOR_ANGLE_LIMIT / 2))
+	{
+		f[C_GMR_FIT_NR_OF_TERMS] -= (int16_t)C_GMR_SENSOR_ANGLE_LIMIT;
+	}
+	else if (f[C_GMR_FIT_NR_OF_TERMS] < -(int16_t)(C_GMR_SENSOR_ANGLE_LIMIT / 2))
+	{
+		f[C_GMR_FIT_NR_OF_TERMS] += (int16_t)C_GMR_SENSOR_ANGLE_LIMIT;
+	}
+	else
+	{
+	}
+
+	harm->samples++;
+	if ((harm->shift < C_GMR_FIT_SHIFT) && ((harm->samples >> (harm->shift + 1u)) != 0u))
+	{
+		harm->shift++;
+	}
+	gmr_fit_accumulate(harm->mean, harm->cov, f, harm->shift, (1L << harm->shift) >> 1);
+}
+/* fit the 4th harmonic to the sweep, called at the end stop that ends it
+ * The estimate waits for gmr_fit_Apply(), the end stops of this calibration were measured with
+ * the coefficients in use. */
+void gmr_harm_Done(void)
+{
+	gmr_harm_t *harm = &l_sGmrHarm;
+	gmr_solve_t solve;
+
+	solve.terms = 0u;
+	if ((harm->state == C_GMR_HARM_LEARN) && (harm->samples >= C_GMR_HARM_MIN_SAMPLES))
+	{
+		gmr_fit_solve_start(&solve, harm->cov);
+		while (gmr_fit_solve_step(&solve, harm->cov, l_ai32GmrHarmPivot) != 0u)
+		{
+		}
+	}
+	if (solve.terms == C_GMR_FIT_NR_OF_TERMS)
+	{
+		/* [0.1deg / 2^13, Q24] -> [0.01deg], on top of the coefficients in use */
+		harm->harmCos = (int16_t)gmr_fit_limit(l16_GmrHarmCos + ((((solve.x[0] >> 8) * 10) + 4) >> 3), C_GMR_HARM_MAX);
+		harm->harmSin = (int16_t)gmr_fit_limit(l16_GmrHarmSin + ((((solve.x[1] >> 8) * 10) + 4) >> 3), C_GMR_HARM_MAX);
+		harm->state = C_GMR_HARM_DONE;
+	}
+	else
+	{
+		harm->state = C_GMR_HARM_OFF;
+	}
+}
+#endif
+/* use the estimates, called at the start of a calibration
+ * The fit is solved at once, the motor stands, a solve gmr_fit_Task() has not finished is
+ * completed first.
+ * @return 1: the correction in use was not measured or the estimate moves the angle, the
+ *            end stops must both be measured again */
+uint8_t gmr_fit_Apply(void)
+{
+	gmr_fit_t *fit = &l_sGmrFit;
+	gmr_correction_t active, corr;
+	uint8_t converged = gmr_fit_converged();
+	uint8_t found = 0u;
+	uint8_t retval = 0u;
+
+	get_gmr_correction(&active);
+	corr = active;
+	if (converged != 0u)
+	{
+		if (fit->solve.state == C_GMR_SOLVE_IDLE)
+		{
+			gmr_fit_solve_start(&fit->solve, fit->cov);
+		}
+		while (gmr_fit_solve_step(&fit->solve, fit->cov, l_ai32GmrFitPivot) != 0u)
+		{
+		}
+		found = gmr_fit_estimate(&corr);
+	}
+#if GMR_HARMONIC_ENABLE == 1
+	if (l_sGmrHarm.state == C_GMR_HARM_DONE)
+	{
+		corr.harmCos = l_sGmrHarm.harmCos;
+		corr.harmSin = l_sGmrHarm.harmSin;
+		l_sGmrHarm.state = C_GMR_HARM_OFF;
+		found = 1u;
+	}
+#endif
+	if (found != 0u)
+	{
+		retval = gmr_correction_moved(&corr, &active);
+		gmr_correction_load(&corr);
+	}
+	if (converged != 0u)
+	{
+		gmr_fit_reset();
+	}
+	return retval;
+}
 void adc_raw_update(void)
 {
-	uint16_t index = 0;
+	uint16_t au16Raw[C_ADC_NR_OF_FAST];
+	uint16_t index;
+
+	au16Raw[C_ADC_CURRENT_ - C_ADC_CURRENT_] = adc_GetRawCurrent();
+	au16Raw[C_ADC_SENSOR_1 - C_ADC_CURRENT_] = adc_Get_GMR_nCosine();
+	au16Raw[C_ADC_SENSOR_2 - C_ADC_CURRENT_] = adc_Get_GMR_nSine();
+	au16Raw[C_ADC_SENSOR_3 - C_ADC_CURRENT_] = adc_Get_GMR_pCosine();
+	au16Raw[C_ADC_SENSOR_4 - C_ADC_CURRENT_] = adc_Get_GMR_pSine();
+#if ADC_FAST_FILTER == C_ADC_FILTER_EXP
+	FILTER_AVG_CalcBankExp(&l_sAdcFastBank, au16Raw);
+#else
+	FILTER_AVG_CalcBank(&l_sAdcFastBank, au16Raw);
+#endif
 
-	for (index = 0; index < C_ADC_END_ITEM; index++)
+	for (index = 0; index < C_ADC_NR_OF_SLOW; index++)
 	{
-		switch (index)
+		if (--l_au8AdcCountdown[index] == 0u)
 		{
-		case C_ADC_VS_:
-			FILTER_AVG_CalcMovAvg(&l_sAdcAvgObject[C_ADC_VS_], adc_GetRawVs());
-			//						temp = l_sAdcAvgObject[C_ADC_VS_].u16MovAvg;
-			break;
-		case C_ADC_TEMP_:
-			FILTER_AVG_CalcMovAvg(&l_sAdcAvgObject[C_ADC_TEMP_], adc_GetRawTemperature());
-			//						temp = l_sAdcAvgObject[C_ADC_TEMP_].u16MovAvg;
-			break;
-		case C_ADC_CURRENT_:
-			FILTER_AVG_CalcMovAvg(&l_sAdcAvgObject[C_ADC_CURRENT_], adc_GetRawCurrent());
-			//						temp = l_sAdcAvgObject[C_ADC_CURRENT_].u16MovAvg;
-			break;
-		case C_ADC_VDDA:
-			FILTER_AVG_CalcMovAvg(&l_sAdcAvgObject[C_ADC_VDDA], adc_GetRawVdda());
-			//						temp = l_sAdcAvgObject[C_ADC_VDDA].u16MovAvg;
-			break;
-		case C_ADC_IGN:
-			FILTER_AVG_CalcMovAvg(&l_sAdcAvgObject[C_ADC_IGN], adc_GetRawIGN());
-			//						temp = l_sAdcAvgObject[C_ADC_VREF_].u16MovAvg;
-			break;
-		case C_ADC_SENSOR_1:
-			FILTER_AVG_CalcMovAvg(&l_sAdcAvgObject[C_ADC_SENSOR_1], adc_Get_GMR_nCosine());
-			//						temp = l_sAdcAvgObject[C_ADC_SENSOR_].u16MovAvg;
-			break;
-		case C_ADC_SENSOR_2:
-			FILTER_AVG_CalcMovAvg(&l_sAdcAvgObject[C_ADC_SENSOR_2], adc_Get_GMR_nSine());
-			//						temp = l_sAdcAvgObject[C_ADC_SENSOR_].u16MovAvg;
-			break;
-		case C_ADC_SENSOR_3:
-			FILTER_AVG_CalcMovAvg(&l_sAdcAvgObject[C_ADC_SENSOR_3], adc_Get_GMR_pCosine());
-			//						temp = l_sAdcAvgObject[C_ADC_SENSOR_].u16MovAvg;
-			break;
-		case C_ADC_SENSOR_4:
-			FILTER_AVG_CalcMovAvg(&l_sAdcAvgObject[C_ADC_SENSOR_4], adc_Get_GMR_pSine());
-			//						temp = l_sAdcAvgObject[C_ADC_SENSOR_].u16MovAvg;
-			break;
-		default:
-			break;
+			l_au8AdcCountdown[index] = l_asAdcChannel[index].u8Period;
+			FILTER_AVG_CalcMovAvg(&l_sAdcAvgObject[index], l_asAdcChannel[index].fGetRaw());
 		}
 	}
 }
 
 int16_t get_sensor_raw_data(uint16_t num)
 {
+	if (num >= C_ADC_CURRENT_)
+	{
+		return (l_au16AdcFastAvg[num - C_ADC_CURRENT_]);
+	}
 	return (l_sAdcAvgObject[num].u16MovAvg);
 }
 uint16_t get_conv_vdda_voltage(void)
@@ -419,18 +1196,190 @@ static uint16_t MLX_to_GMR_conv(uint16_t angle)
 u16 loc_rotor_angle_estimated = math_get_angle_unsafe( loc_e_beta_filtered, loc_e_alpha_filtered );
 */
 
+#if GMR_PLAUSIBILITY_ENABLE == 1
+/* debounce the failed checks (bit set: failed) into the fault word, a fault is set after a
+ * check failed C_GMR_FAULT_DEBOUNCE samples more than it passed and cleared when it passed
+ * as often again */
+static void gmr_fault_debounce(uint8_t failed)
+{
+	uint16_t i;
+	uint8_t bit = 1u;
+
+	for (i = 0u; i < C_GMR_FAULT_NR_OF_CHECKS; i++)
+	{
+		if ((failed & bit) != 0u)
+		{
+			if (l_au8GmrFaultCount[i] < C_GMR_FAULT_DEBOUNCE)
+			{
+				l_au8GmrFaultCount[i]++;
+			}
+			if (l_au8GmrFaultCount[i] >= C_GMR_FAULT_DEBOUNCE)
+			{
+				l_u8GmrFault |= bit;
+			}
+		}
+		else if (l_au8GmrFaultCount[i] > 0u)
+		{
+			l_au8GmrFaultCount[i]--;
+			if (l_au8GmrFaultCount[i] == 0u)
+			{
+				l_u8GmrFault &= (uint8_t)~bit;
+			}
+		}
+		else
+		{
+		}
+		bit <<= 1;
+	}
+}
+/* plausibility of the bridge outputs, with every angle
+ * An open or shorted bridge leg or a saturated input pulls the leg to a rail, and moves the
+ * magnitude of the sine/cosine vector, which is the amplitude at every angle, off it. The
+ * magnitude has to stay within the measured amplitude +/- 50% (the magnitude approximation
+ * is 4% off at most), before the amplitude is measured above C_GMR_FIT_AMP_MIN. Faults
+ * are set after C_GMR_FAULT_DEBOUNCE samples, long before the stalled motor is seen by
+ * valveDiagSensor(). */
+static void gmr_plausibility_check(int16_t sine, int16_t cosine)
+{
+	uint8_t failed = 0u;
+	uint8_t bit = C_GMR_FAULT_LEG1;
+	uint16_t num, leg, magnitude;
+	uint16_t low = C_GMR_FIT_AMP_MIN;
+	uint16_t high = 0xFFFFu;
+
+	if (l_u8GmrFaultSettle != 0u)
+	{
+		l_u8GmrFaultSettle--;
+	}
+	else
+	{
+		for (num = C_ADC_SENSOR_1; num <= C_ADC_SENSOR_4; num++)
+		{
+			leg = (uint16_t)get_sensor_raw_data(num);
+			if ((leg <= C_GMR_LEG_RAIL) || (leg >= (C_GMR_ADC_FULL_SCALE - C_GMR_LEG_RAIL)))
+			{
+				failed |= bit;
+			}
+			bit <<= 1;
+		}
+		if (l16_SinAmplitude != 0)
+		{
+			low = (uint16_t)l16_SinAmplitude >> 1;
+			high = (uint16_t)l16_SinAmplitude + low;
+		}
+		magnitude = calculate_vector_magnitude(sine, cosine);
+		if ((magnitude < low) || (magnitude > high))
+		{
+			failed |= C_GMR_FAULT_MAGNITUDE;
+		}
+		if ((sine == C_GMR_POSITIVE_MAX) || (sine == C_GMR_NEGAITIVE_MAX) ||
+			(cosine == C_GMR_POSITIVE_MAX) || (cosine == C_GMR_NEGAITIVE_MAX))
+		{
+			failed |= C_GMR_FAULT_CLIP;
+		}
+		gmr_fault_debounce(failed);
+	}
+}
+/* debounced GMR fault word, C_GMR_FAULT_LEG1 .. C_GMR_FAULT_CLIP, 0: plausible */
+uint8_t get_gmr_fault(void)
+{
+	return l_u8GmrFault;
+}
+#endif
 int16_t calculate_gmr_angle(void)
 {
 	int16_t ang_result;
+	int16_t sine = get_gmr_sine_output();
+	int16_t cosine = gmr_cosine_correct(sine, get_gmr_cosine_output());
 
-	ang_result = (int16_t)atan2I16(get_gmr_cosine_output(), get_gmr_sine_output());
+#if GMR_PLAUSIBILITY_ENABLE == 1
+	gmr_plausibility_check(sine, cosine);
+#endif
 
+#if GMR_ATAN2_KERNEL == C_GMR_ATAN2_FM_LUT
+	ang_result = fm_Atan2I16DirectLutInlined(cosine, sine);
+#elif GMR_ATAN2_KERNEL == C_GMR_ATAN2_FM_INTERP
+	ang_result = fm_Atan2I16InterpolationInlined(cosine, sine);
+#elif GMR_ATAN2_KERNEL == C_GMR_ATAN2_FM_INTERP_CALL
+	ang_result = fm_Atan2I16InterpolationNonInlined(cosine, sine);
+#else
+	ang_result = (int16_t)atan2I16(cosine, sine);
+#endif
+
+#if GMR_HARMONIC_ENABLE == 1
+	l_u16GmrAngleRaw = (uint16_t)ang_result;
+#endif
 	/* output angle(0~0xFFFF) -> 0~360 degree */
 	ang_result = MLX_to_GMR_conv(ang_result);
+#if GMR_HARMONIC_ENABLE == 1
+	ang_result -= gmr_harm_error(l_u16GmrAngleRaw);
+	if (ang_result < 0)
+	{
+		ang_result += (int16_t)C_GMR_SENSOR_ANGLE_LIMIT;
+	}
+	else if (ang_result >= (int16_t)C_GMR_SENSOR_ANGLE_LIMIT)
+	{
+		ang_result -= (int16_t)C_GMR_SENSOR_ANGLE_LIMIT;
+	}
+	else
+	{
+	}
+#endif
 
 	return ang_result;
 }
 
+/* restart the multi-turn tracker at revolution 0 with the next angle */
+void gmr_angle_track_reset(void)
+{
+	l_u8GmrTrackInit = 0u;
+}
+
+/* wrapped 0~3600 angle -> continuous angle, called every 100us
+ * The shaft turns far less than half a revolution per call, so a step of more than
+ * 180 degree is the 0/360 seam. A change of the sensor offset shifts the continuous
+ * angle the same way as the wrapped one. */
+int32_t gmr_angle_unwrap(int16_t angle)
+{
+	int16_t step;
+
+	if (l_u8GmrTrackInit == 0u)
+	{
+		l_u8GmrTrackInit = 1u;
+		l_i16GmrTurns = 0;
+		l_i32GmrAngleUnwrapped = angle;
+	}
+	else
+	{
+		step = angle - l_i16GmrAngleLast;
+		if (step > (int16_t)(C_GMR_SENSOR_ANGLE_LIMIT / 2))
+		{
+			step -= (int16_t)C_GMR_SENSOR_ANGLE_LIMIT;
+			l_i16GmrTurns -= 1;
+		}
+		else if (step < -(int16_t)(C_GMR_SENSOR_ANGLE_LIMIT / 2))
+		{
+			step += (int16_t)C_GMR_SENSOR_ANGLE_LIMIT;
+			l_i16GmrTurns += 1;
+		}
+		else
+		{
+		}
+		l_i32GmrAngleUnwrapped += step;
+	}
+	l_i16GmrAngleLast = angle;
+
+	return l_i32GmrAngleUnwrapped;
+}
+int32_t get_gmr_angle_unwrapped(void)
+{
+	return l_i32GmrAngleUnwrapped;
+}
+int16_t get_gmr_angle_turns(void)
+{
+	return l_i16GmrTurns;
+}
+
 int16_t forward_linear_Interpolation(int16_t x, int16_t x0, int16_t x1, int16_t y0, int16_t y1)
 {
 	int16_t tmp = 0;
@@ -20,13 +20,35 @@
 #define C_GMR_POSITIVE_MAX (int16_t)0x3FFFu
 #define C_GMR_NEGAITIVE_MAX (int16_t)(-0x3FFFu)
 
+#define C_GMR_GAIN_ONE 16384 /* cosine output gain 1.0 [Q14] */
+#define C_GMR_CORR_TOL_SHIFT 7u /* correction change that moves the angle, amplitude >> 7 = 0.45deg */
+#define C_GMR_FIT_MIN_SAMPLES 2000u /* samples during moves before an estimate is used [1ms] */
+#define C_GMR_FIT_MIN_BINS 4u /* 22.5deg sectors of the sensor angle seen before an estimate is used */
+#define C_GMR_FIT_OFFSET_MAX 64 /* estimated output offset limit [LSB] */
+#define C_GMR_FIT_AMP_MIN 64 /* estimated amplitude lower limit [LSB] */
+#define C_GMR_FIT_GAIN_RANGE 2048 /* estimated cosine gain limit, 1.0 +/- 0.125 [Q14] */
+#define C_GMR_FIT_QUAD_MAX 4096 /* estimated quadrature limit, sin(7.2deg) [Q15] */
+#define C_GMR_HARM_MAX 90 /* estimated 4th harmonic coefficient limit [0.01deg] */
+#define C_GMR_HARM_TOL 15 /* 4th harmonic change that moves the angle [0.01deg] */
+#define C_GMR_ADC_FULL_SCALE 1023u /* adc full scale of a bridge leg [LSB] */
+#define C_GMR_LEG_RAIL 8u /* bridge leg this close to 0 or the full scale is open or shorted [LSB] */
+#define C_GMR_FAULT_DEBOUNCE 5u /* samples a plausibility check fails before its fault is set [100us] */
+
+/* GMR fault word, get_gmr_fault() */
+#define C_GMR_FAULT_LEG1 0x01u /* nCosine (C_ADC_SENSOR_1) at a rail */
+#define C_GMR_FAULT_LEG2 0x02u /* nSine (C_ADC_SENSOR_2) at a rail */
+#define C_GMR_FAULT_LEG3 0x04u /* pCosine (C_ADC_SENSOR_3) at a rail */
+#define C_GMR_FAULT_LEG4 0x08u /* pSine (C_ADC_SENSOR_4) at a rail */
+#define C_GMR_FAULT_MAGNITUDE 0x10u /* sine/cosine vector magnitude off the amplitude */
+#define C_GMR_FAULT_CLIP 0x20u /* sine or cosine output clipped at C_GMR_POSITIVE_MAX */
+
 enum
 {
   C_ADC_VS_ = 0,
   C_ADC_TEMP_,
-  C_ADC_CURRENT_,
   C_ADC_VDDA,
   C_ADC_IGN,
+  C_ADC_CURRENT_, /* first channel of the 100us filter bank */
   C_ADC_SENSOR_1,
   C_ADC_SENSOR_2,
   C_ADC_SENSOR_3,
@@ -52,12 +74,35 @@ typedef struct
   uint32_t actual;
   uint32_t correction;
 } conversion_t;
+
+/* GMR bridge output correction, kept in the calibration record */
+typedef struct
+{
+  int16_t sinOffset;    /* sine output offset [LSB] */
+  int16_t cosOffset;    /* cosine output offset [LSB] */
+  int16_t sinAmplitude; /* sine output amplitude [LSB], 0: not measured */
+  int16_t cosAmplitude; /* cosine output amplitude [LSB], 0: not measured */
+  int16_t quadrature;   /* cosine output phase error, sin(phase) [Q15] */
+  int16_t harmCos;      /* angle error cos(4 sensor angle) part [0.01deg] */
+  int16_t harmSin;      /* angle error sin(4 sensor angle) part [0.01deg] */
+} gmr_correction_t;
 void sensor_init(void);
 void adc_raw_update(void);
 void gmr_calibration_setup(void);
 void gmr_calibration_end(void);
 void set_gmr_sensor_offset(int16_t offset);
 int16_t get_gmr_sensor_offset(void);
+void get_gmr_correction(gmr_correction_t *corr);
+void set_gmr_correction(const gmr_correction_t *corr);
+uint8_t gmr_correction_moved(const gmr_correction_t *a, const gmr_correction_t *b);
+void gmr_fit_Update(int16_t angle);
+void gmr_fit_Track(void);
+uint8_t gmr_fit_Task(void);
+uint8_t gmr_fit_Apply(void);
+void gmr_harm_Start(void);
+void gmr_harm_Update(int16_t angle, uint8_t use);
+void gmr_harm_Done(void);
+uint8_t get_gmr_fault(void);
 int16_t get_sensor_raw_data(uint16_t num);
 uint16_t get_conv_vdda_voltage(void);
 uint16_t get_conv_supply_voltage(void);
@@ -67,6 +112,10 @@ uint16_t get_conv_ignition_voltage(void);
 int16_t get_gmr_sine_output(void);
 int16_t get_gmr_cosine_output(void);
 int16_t calculate_gmr_angle(void);
+void gmr_angle_track_reset(void);
+int32_t gmr_angle_unwrap(int16_t angle);
+int32_t get_gmr_angle_unwrapped(void);
+int16_t get_gmr_angle_turns(void);
 int16_t forward_linear_Interpolation(int16_t x, int16_t x0, int16_t x1, int16_t y0, int16_t y1);
 int16_t reverse_linear_Interpolation(int16_t x, int16_t x0, int16_t x1, int16_t y0, int16_t y1);
 #endif /* CODE_SRC_DCM_SENSOR_H_ */
@@ -22,6 +22,11 @@
 #include "AppValve.h"
 #include "AppLin.h"
 #include "eeprom_app.h"
+#include "profiler.h"
+
+#if C_BRAKE_BINS != C_BRAKE_NV_ENTRIES
+#error "brake distance table does not fit EEPROM page 4"
+#endif
 /* local variables */
 struct {
     tMotState state;
@@ -29,20 +34,57 @@ struct {
 	uint16_t initStatus;		
 	uint16_t elapsedTime;		
     uint16_t requestStop;        /* 0: No request, 1: Request stop */
-    int16_t speed;              /* current speed [PPS] */
+    int16_t speed;              /* current speed [0.1deg/s], signed like contCurrent */
     tMotDirection direction;          /* 1 : forward, -1 : backward */
     tMotDirection lastDirection; 	
     uint16_t runTimeOut;        /*  */	
 	uint16_t holdTime;
     struct {
-	int16_t current;
-	int16_t target;
+	int16_t current;		/* wrapped angle 0~3600 */
+	int16_t target;			/* target in the frame of the current revolution */
 	int16_t lastTarget;		
-	int16_t Delta;
+	int16_t Delta;			/* contTarget - contCurrent, saturated */
+	int32_t contCurrent;	/* continuous (multi-turn) angle */
+	int32_t contTarget;		/* continuous target */
 	uint8_t newTarget;			
 	uint8_t posReached;		
     } pos;
 
+    struct {
+	int32_t posInt;			/* estimated continuous angle, integer part [0.1deg] */
+	uint16_t posFrac;		/* estimated continuous angle, fraction [0.1deg/65536] */
+	int32_t vel;			/* estimated speed [0.1deg/65536 per 100us] */
+	uint8_t seeded;			/* 0: seed with the next angle */
+    } obs;
+
+    struct {
+	uint8_t mode;			/* C_MOT_CTRL_RAMP, C_MOT_CTRL_PID or C_MOT_CTRL_SCURVE */
+	uint16_t kp;			/* [Q8] duty per 0.1deg */
+	uint16_t ki;			/* [Q8] duty per 0.1deg*ms */
+	uint16_t kd;			/* [Q8] duty per 0.1deg/s */
+	int32_t integ;			/* integral term [Q8 duty] */
+	int16_t output;			/* last output [duty], signed like Delta */
+    } ctrl;
+
+    struct {
+	uint16_t r25;			/* winding resistance at 25C [mOhm] */
+	uint16_t rTc;			/* winding resistance temperature coefficient [1/K, Q16] */
+	uint16_t ke;			/* back-EMF constant at the valve shaft [mV per deg/s] */
+    } model;
+
+    struct {
+	int32_t start;			/* continuous angle at the start of the profile */
+	int8_t dir;				/* 1: towards larger angles, -1: towards smaller ones */
+	uint8_t saturated;		/* last output was saturated */
+	uint8_t idx;			
+	int16_t trapVel;		/* trapezoidal profile speed [0.1deg/s] */
+	int32_t trapPos;		/* trapezoidal profile travel [0.1deg/1000] */
+	int32_t velSum;			/* sum of vel[] */
+	int32_t refPos;			/* reference travel [0.1deg/1000] * C_TRAJ_JERK_MS */
+	int16_t vel[C_TRAJ_JERK_MS];	/* trapezoidal profile speed history */
+	int32_t integ;			/* velocity loop integral [Q8 duty] */
+    } traj;
+
     struct {
 		uint16_t enable;		
         uint16_t outThreshold;           /*  */
@@ -55,13 +97,81 @@ struct {
         uint16_t dccDuty;           /* dcceleration duty */
     } softStop;
 
+    struct {
+	uint8_t active;			/* 1: braking for a reversal */
+	uint8_t slowCnt;		
+	uint16_t time;			/* brake time [ms] */
+    } reverse;
+
+    struct {
+	int32_t start;			/* continuous angle at the start of the pulse */
+	int16_t base;			/* pulse duty without the error part, the learned breakaway duty [duty] */
+	int16_t trim;			/* adaption of base within this correction [duty] */
+	int16_t lastDelta;		/* Delta at the start of the pulse */
+	uint16_t time;			/* pulse or standing time [ms] */
+	uint8_t pulses;			/* pulses of this correction */
+	uint8_t pulse;			/* 1: pulse on */
+    } fine;
+
     struct {
         uint16_t enable;             /*  */
         uint16_t duty;              /* */
         uint16_t maxDuty;              /* */			
         uint16_t minDuty;              /* */		
+        uint16_t brake;              /* brake strength instead of the duty, 0: drive */
     } out;
 
+    struct {
+	uint16_t voltage;		/* supply voltage of the compensation [10mV] */
+    } supply;
+
+    struct {
+	int16_t dist[C_BRAKE_BINS];	/* learned brake distance [0.1deg], 0: not learned */
+	mot_brake_table_t table;	/* copy of the EEPROM table */
+	int32_t start;			/* continuous angle at the start of the braking */
+	uint16_t time;			/* time since the start of the braking [ms] */
+	uint8_t bin;			/* operating point of the move */
+	uint8_t measure;		/* 1: braking is measured */
+	uint8_t slowCnt;		
+	uint8_t store;			/* 1: table to be stored while stopped */
+    } brake;
+
+    struct {
+	uint16_t duty[C_BREAKAWAY_TBINS];	/* learned breakaway duty at C_MOT_VREF, 0: not learned */
+	mot_breakaway_table_t table;	/* copy of the EEPROM table */
+	int32_t floor;			/* lowest back-EMF model speed of the start [0.1deg/s] */
+	uint8_t bin;			/* temperature band of the start */
+	uint8_t measure;		/* 1: start from rest is measured */
+	uint8_t store;			/* 1: table to be stored while stopped */
+    } breakaway;
+
+    struct {
+	int16_t play;			/* gearbox play at the valve shaft [0.1deg] */
+	int32_t final;			/* continuous target of the approach [0.1deg] */
+	int32_t start;			/* continuous angle at the start of the measurement */
+	int32_t travel;			/* back-EMF model travel since the start [0.1deg/1000] */
+	int32_t onset;			/* model travel when the valve followed [0.1deg/1000] */
+	int16_t onsetMoved;		/* valve travel when the valve followed [0.1deg] */
+	uint16_t current;		/* current peak, then the lowest current since [mA] */
+	uint8_t peak;			/* 1: current past its peak */
+	uint8_t approach;		/* 1: running past the target, the approach follows */
+	uint8_t load;			/* 1: approach, the valve did not follow yet, the play adds to the error */
+	uint8_t arm;			/* 1: next start from rest is measured */
+	uint8_t measure;		/* 1: start is measured */
+    } backlash;
+
+    struct {
+	int16_t tau;			/* model time constant [1/1024 s] */
+	int16_t predicted;		/* coast of the model at the cut-off [0.1deg] */
+	int32_t start;			/* continuous angle at the cut-off */
+	int32_t target;			/* continuous target at the cut-off */
+	int16_t speed;			/* speed at the cut-off [0.1deg/s], towards the target */
+	uint16_t time;			/* time since the cut-off [ms] */
+	uint8_t measure;		/* 1: coast is measured */
+	uint8_t slowCnt;		
+	tMotCoastLog log;
+    } coast;
+
     struct {
         int16_t rawCurrent;  /* motor current [mA] */
         int16_t filteredCurrent;   /* filtered motor current through LPF [mA] */
@@ -76,6 +186,13 @@ struct {
 		uint16_t threshold;	/* stall threshold [mA] */
 		uint16_t obstrCnt;			
     } stall;
+
+    struct {
+		uint16_t confirm;			/* confirmation time [ms], 0: detector off */
+		uint16_t count;				/* confirmation counter [ms] */
+		uint16_t current[C_ENDSTOP_RISE_MS];	/* current history [mA] */
+		uint8_t idx;				
+    } endStop;
 	
     struct {
         uint8_t flag;              /* fault flag */
@@ -90,13 +207,27 @@ struct {
 struct {
     tSensorCondition moving;
     uint8_t delay;		
-    int8_t filterPeriod;	
     int8_t filterCnt;
-    int16_t delta;	
+    int16_t delta;			/* travel per 20ms from the observer speed [0.1deg] */
     int16_t thd;			
-    int16_t lastDeg;		
 } sensor;	
 
+/* thresholds over the supply voltage, interpolated between the points */
+static const struct {
+	uint16_t voltage;		/* [10mV] */
+	int16_t sensorThd;		/* sensor.thd [0.1deg per 20ms] */
+	uint16_t halfThd;		/* stall.halfThd [mA] */
+	uint16_t stallThd;		/* stall.threshold [mA] */
+} l_asMotVsTable[] = {
+	{ 900u, 10, 550u,  650u},
+	{1000u, 11, 600u,  700u},
+	{1100u, 12, 650u,  750u},
+	{1200u, 14, 700u,  800u},
+	{1350u, 16, 800u,  900u},
+	{1500u, 17, 900u, 1000u},
+};
+#define C_MOT_VS_POINTS (sizeof(l_asMotVsTable) / sizeof(l_asMotVsTable[0]))
+
 void MotRequestHardStop(void)
 {
 	motor.requestStop = 1;
@@ -105,23 +236,64 @@ void MotClearHardStop(void)
 {
 	motor.requestStop = 0;
 }
+/*
+A target within 0~3600 is reached the short way, also across the 0/360 seam: the valve
+travel is less than half a revolution. A target outside (-100, 3700) is taken in the
+frame of the current revolution, i.e. "past 0" and "past 360".
+The continuous target is kept while the target is unchanged. A target against
+C_BACKLASH_APPROACH_DIR is run past by C_BACKLASH_MARGIN first, the move ends with the
+approach from there: the gears are always loaded from the same side. The GMR reads the
+valve shaft, the margin only has to take the valve clear of the target. On the way back the
+rotor turns the learned play before the valve follows, the approach adds it to the error it
+drives from (MotFineReach(), motor_state_FINE()). A play within C_BACKLASH_IGNORE needs no
+approach.
+*/
 void MotSetTargetPosition(int16_t targetPos)
 {
-	int16_t diff;
-#if 0
-	if (targetPos > (360 * C_GMR_ANGLE_SCALE_FACTOR))
+	int32_t diff;
+
+	if (targetPos != motor.pos.target)
 	{
-		targetPos -= (360 * C_GMR_ANGLE_SCALE_FACTOR);
+		if ((targetPos >= 0) && (targetPos < (int16_t)C_GMR_SENSOR_ANGLE_LIMIT))
+		{
+			diff = targetPos - motor.pos.current;
+			if (diff > (int16_t)(C_GMR_SENSOR_ANGLE_LIMIT / 2))
+			{
+				diff -= (int16_t)C_GMR_SENSOR_ANGLE_LIMIT;
+			}
+			else if (diff < -(int16_t)(C_GMR_SENSOR_ANGLE_LIMIT / 2))
+			{
+				diff += (int16_t)C_GMR_SENSOR_ANGLE_LIMIT;
+			}
+			else
+			{
+			}
+			motor.pos.contTarget = motor.pos.contCurrent + diff;
+		}
+		else
+		{
+			motor.pos.contTarget = (motor.pos.contCurrent - motor.pos.current) + targetPos;
+		}
+#if BACKLASH_APPROACH_ENABLE == 1
+		/* against the approach direction: run past the target, the approach takes up the play */
+		motor.backlash.approach = 0u;
+		motor.backlash.load = 0u;
+		if ((get_valve_mode() != VALVE_CALIBRATION) && (motor.backlash.play > (int16_t)C_BACKLASH_IGNORE) && (((motor.pos.contTarget - motor.pos.contCurrent) * C_BACKLASH_APPROACH_DIR) < -(int32_t)C_MOT_ON_HYSTERISYS))
+		{
+			motor.backlash.final = motor.pos.contTarget;
+			motor.pos.contTarget -= C_BACKLASH_APPROACH_DIR * (int32_t)C_BACKLASH_MARGIN;
+			motor.backlash.approach = 1u;
+		}
+#endif
 	}
-#endif	
 	motor.pos.target = targetPos;
-	if (motor.pos.target >= motor.pos.current)
+	if (motor.pos.contTarget >= motor.pos.contCurrent)
 	{
-		diff=motor.pos.target-motor.pos.current;
+		diff=motor.pos.contTarget-motor.pos.contCurrent;
 	}
 	else 
 	{
-		diff=motor.pos.current-motor.pos.target;
+		diff=motor.pos.contCurrent-motor.pos.contTarget;
 	}
 	if ((motor.pos.target != motor.pos.lastTarget) || (diff > (int16_t)C_MOT_ON_HYSTERISYS))
 	{
@@ -131,12 +303,6 @@ void MotSetTargetPosition(int16_t targetPos)
 }
 void MotSetCurrentPosition(int16_t currentPos)
 {
-#if 0
-	if (currentPos > (360 * C_GMR_ANGLE_SCALE_FACTOR))
-	{
-		currentPos -= (360 * C_GMR_ANGLE_SCALE_FACTOR);
-	}
-#endif	
 	motor.pos.current = currentPos;
 }
 int16_t MotGetTargetPosition(void)
@@ -148,6 +314,18 @@ int16_t MotGetCurrentPosition(void)
 	return motor.pos.current;
 
 }
+int32_t MotGetContinuousTarget(void)
+{
+	return motor.pos.contTarget;
+}
+int32_t MotGetContinuousPosition(void)
+{
+	return motor.pos.contCurrent;
+}
+int16_t MotGetSpeed(void)
+{
+	return motor.speed;
+}
 void MotSetParam(int16_t sensorThd,int16_t stallThd)
 {
 	sensor.thd = sensorThd;
@@ -162,6 +340,67 @@ void MotSetMaxDuty(uint16_t duty)
 motor.out.maxDuty=duty;
 }
 /*
+confirmTime [ms] : time the end-stop condition has to hold during calibration, 0 : off
+*/
+void MotSetEndStopConfirm(uint16_t confirmTime)
+{
+	motor.endStop.confirm = confirmTime;
+	motor.endStop.count = 0;
+}
+/*
+play [0.1deg] : gearbox play of the approach, out of 0~C_BACKLASH_MAX : C_BACKLASH_DEFAULT
+*/
+void MotSetBacklash(int16_t play)
+{
+	if ((play < 0) || (play > (int16_t)C_BACKLASH_MAX))
+	{
+		play = (int16_t)C_BACKLASH_DEFAULT;
+	}
+	motor.backlash.play = play;
+}
+int16_t MotGetBacklash(void)
+{
+	return motor.backlash.play;
+}
+/*
+the next start from rest measures the gearbox play, it has to start with the gears loaded the
+other way, e.g. from an end stop
+*/
+void MotMeasureBacklash(void)
+{
+	motor.backlash.arm = 1u;
+}
+/*
+last measured coast after a cut-off, for tuning the coast model
+*/
+const tMotCoastLog *MotGetCoastLog(void)
+{
+	return &motor.coast.log;
+}
+/*
+mode : C_MOT_CTRL_RAMP, C_MOT_CTRL_PID or C_MOT_CTRL_SCURVE, other values are ignored
+*/
+void MotSetCtrlMode(uint8_t mode)
+{
+	if ((mode == C_MOT_CTRL_RAMP) || (mode == C_MOT_CTRL_PID) || (mode == C_MOT_CTRL_SCURVE))
+	{
+		motor.ctrl.mode = mode;
+	}
+}
+uint8_t MotGetCtrlMode(void)
+{
+	return motor.ctrl.mode;
+}
+/*
+PID gains [Q8], see C_PID_KP, C_PID_KI and C_PID_KD, taken over with the next 1ms step
+*/
+void MotSetPidGains(uint16_t kp, uint16_t ki, uint16_t kd)
+{
+	motor.ctrl.kp = kp;
+	motor.ctrl.ki = ki;
+	motor.ctrl.kd = kd;
+}
+/*
 type 0 : all clear
 */
 void MotClearStallFlag(uint16_t type)
@@ -231,6 +470,727 @@ int16_t SensorGetDelta(void)
 {
 	return sensor.delta;
 }
+/* add a signed amount [0.1deg/65536] to the observer angle */
+static void MotObserverAdd(int32_t amount)
+{
+	int32_t sum = (int32_t)motor.obs.posFrac + amount;
+
+	motor.obs.posInt += (sum >> 16);
+	motor.obs.posFrac = (uint16_t)sum;
+}
+/*
+alpha-beta observer on the continuous angle, 100usec
+predict: x += v, correct: x += alpha * (z - x), v += beta * (z - x)
+speed [0.1deg/s] = v * 10000 / 65536
+*/
+static void MotSpeedObserver(void)
+{
+	int32_t err;
+
+	if (motor.obs.seeded != 0)
+	{
+		MotObserverAdd(motor.obs.vel);
+	}
+	err = motor.pos.contCurrent - motor.obs.posInt;
+	if ((motor.obs.seeded == 0) || (err > C_OBS_RESEED_ERROR) || (err < -C_OBS_RESEED_ERROR))
+	{
+		motor.obs.posInt = motor.pos.contCurrent;
+		motor.obs.posFrac = 0;
+		motor.obs.vel = 0;
+		motor.obs.seeded = 1;
+	}
+	else
+	{
+		err = (err << 16) - motor.obs.posFrac;
+		MotObserverAdd(err >> C_OBS_ALPHA_SHIFT);
+		motor.obs.vel += (err >> C_OBS_BETA_SHIFT);
+	}
+	motor.speed = (int16_t)((motor.obs.vel * 625) >> 12);
+}
+/*
+PID position loop, 1msec, in the frame of motor.pos.Delta
+u = (Kp * e + Ki * sum(e) - Kd * speed) / 256 [duty], the sign of u gives the direction.
+minDuty is fed forward against the friction: duty = minDuty + |u|, limited to maxDuty and
+rising by at most softStart.accDuty per ms like ACC does.
+The integral holds while the output saturates in the direction of the error (anti-windup).
+*/
+static void MotPositionPid(void)
+{
+	int32_t err = motor.pos.Delta;
+	int32_t u;
+	int32_t limit;
+	uint16_t mag;
+	uint16_t duty;
+	uint8_t saturated = 0;
+
+	u = ((int32_t)motor.ctrl.kp * err) + motor.ctrl.integ - ((int32_t)motor.ctrl.kd * motor.speed);
+	u >>= 8;
+	mag = (u >= 0) ? (uint16_t)((u > (int32_t)C_MOT_MAXDUTY_SET) ? C_MOT_MAXDUTY_SET : u)
+				   : (uint16_t)((u < -(int32_t)C_MOT_MAXDUTY_SET) ? C_MOT_MAXDUTY_SET : -u);
+	duty = motor.out.minDuty + mag;
+	if (duty >= motor.out.maxDuty)
+	{
+		duty = motor.out.maxDuty;
+		saturated = 1;
+	}
+	/* soft start, also after a reversal */
+	if (((u >= 0) && (motor.ctrl.output > 0)) || ((u < 0) && (motor.ctrl.output < 0)))
+	{
+		limit = ((motor.ctrl.output > 0) ? motor.ctrl.output : -motor.ctrl.output) + motor.softStart.accDuty;
+	}
+	else
+	{
+		limit = motor.out.minDuty;
+	}
+	if (duty > limit)
+	{
+		duty = (uint16_t)limit;
+	}
+	motor.ctrl.output = (u >= 0) ? (int16_t)duty : -(int16_t)duty;
+
+	if ((saturated == 0) || ((u >= 0) != (err >= 0)))
+	{
+		motor.ctrl.integ += (int32_t)motor.ctrl.ki * err;
+		limit = (int32_t)motor.out.maxDuty << 8;
+		if (motor.ctrl.integ > limit)
+		{
+			motor.ctrl.integ = limit;
+		}
+		else if (motor.ctrl.integ < -limit)
+		{
+			motor.ctrl.integ = -limit;
+		}
+		else
+		{
+		}
+	}
+
+#if C_MOT_POLE_POLAR==0
+	motor.direction = (u >= 0) ? C_DIR_CW : C_DIR_CCW;
+#else
+	motor.direction = (u >= 0) ? C_DIR_CCW : C_DIR_CW;
+#endif
+	motor.out.duty = duty;
+}
+/* start a profile from the current angle towards contTarget */
+static void MotTrajectoryInit(void)
+{
+	uint8_t i;
+
+	motor.traj.start = motor.pos.contCurrent;
+	motor.traj.dir = (motor.pos.contTarget >= motor.pos.contCurrent) ? 1 : -1;
+	motor.traj.saturated = 0;
+	motor.traj.idx = 0;
+	motor.traj.trapVel = 0;
+	motor.traj.trapPos = 0;
+	motor.traj.velSum = 0;
+	motor.traj.refPos = 0;
+	motor.traj.integ = 0;
+	for (i = 0; i < C_TRAJ_JERK_MS; i++)
+	{
+		motor.traj.vel[i] = 0;
+	}
+}
+/* travel to stop from speed vel with C_TRAJ_ACC [0.1deg/1000] */
+static int32_t MotTrajectoryStopDist(int16_t vel)
+{
+	return ((int32_t)vel * vel) / (2 * C_TRAJ_ACC);
+}
+/*
+S-curve trajectory with velocity loop, 1msec
+The trapezoidal profile accelerates as long as it can still stop within the remaining
+travel, so a target moved further away is followed at speed. Averaging its speed over
+C_TRAJ_JERK_MS limits the jerk and keeps the travel: the reference arrives exactly one jerk
+time after the trapezoid. Travel is counted along the move in [0.1deg/1000], the sum of the
+speeds [0.1deg/s] per ms. The profile holds while the output saturates behind it.
+duty = minDuty + back-EMF(vcmd) + Kv * (vcmd - speed) + Ki * sum(vcmd - speed), the
+velocity command vcmd is the reference speed plus Kpos times the following error.
+A target behind the profile is taken with a new profile once the current one stopped.
+return : MOTION_ACC, MOTION_RUNNING or MOTION_DEC, the phase of the trapezoid
+*/
+static tMotState MotTrajectory(uint16_t voltage)
+{
+	tMotState phase = MOTION_DEC;
+	int32_t travel = (motor.pos.contTarget - motor.traj.start) * motor.traj.dir * 1000;
+	int32_t pos = (motor.pos.contCurrent - motor.traj.start) * motor.traj.dir * 1000;
+	int32_t remain = travel - motor.traj.trapPos;
+	int32_t perr = (motor.traj.refPos >> C_TRAJ_JERK_SHIFT) - pos;
+	int16_t vel = motor.traj.trapVel;
+	int16_t up = vel + C_TRAJ_ACC;
+	int32_t vcmd;
+	int32_t verr;
+	int32_t u;
+	uint16_t mag;
+
+	if ((remain < 0) && (vel == 0) && (motor.traj.velSum == 0))
+	{
+		MotTrajectoryInit();
+		travel = (motor.pos.contTarget - motor.traj.start) * motor.traj.dir * 1000;
+		remain = travel;
+		perr = 0;
+		up = C_TRAJ_ACC;
+	}
+	if ((motor.traj.saturated == 0) || (perr < C_TRAJ_HOLD_ERROR))
+	{
+		if (up > C_TRAJ_VMAX)
+		{
+			up = C_TRAJ_VMAX;
+		}
+		if ((MotTrajectoryStopDist(up) + up) <= remain)
+		{
+			phase = (up > vel) ? MOTION_ACC : MOTION_RUNNING;
+			vel = up;
+		}
+		else if ((MotTrajectoryStopDist(vel) + vel) <= remain)
+		{
+			phase = MOTION_RUNNING;
+		}
+		else
+		{
+			vel = (vel > C_TRAJ_ACC) ? (vel - C_TRAJ_ACC) : 0;
+		}
+		if (vel > remain)
+		{
+			vel = (remain > 0) ? (int16_t)remain : 0;
+		}
+		motor.traj.trapVel = vel;
+		motor.traj.trapPos += vel;
+		motor.traj.velSum += vel - motor.traj.vel[motor.traj.idx];
+		motor.traj.vel[motor.traj.idx] = vel;
+		motor.traj.idx = (motor.traj.idx + 1u) & (C_TRAJ_JERK_MS - 1u);
+		motor.traj.refPos += motor.traj.velSum;
+	}
+	else
+	{
+		phase = motor.state;
+	}
+
+	/* velocity loop along the move */
+	vcmd = (motor.traj.velSum >> C_TRAJ_JERK_SHIFT) + ((C_TRAJ_KPOS * perr) / 1000);
+	verr = vcmd - ((int32_t)motor.speed * motor.traj.dir);
+	u = ((vcmd * (int32_t)motor.model.ke * (int32_t)C_PWMOUT_MAX_DUTY) / (100 * (int32_t)voltage)) + (((C_TRAJ_KV * verr) + motor.traj.integ) >> 8);
+	if (vcmd > 0)
+	{
+		u += motor.out.minDuty;
+	}
+	else if (vcmd < 0)
+	{
+		u -= motor.out.minDuty;
+	}
+	else
+	{
+	}
+	mag = (u >= 0) ? (uint16_t)((u > (int32_t)C_MOT_MAXDUTY_SET) ? C_MOT_MAXDUTY_SET : u)
+				   : (uint16_t)((u < -(int32_t)C_MOT_MAXDUTY_SET) ? C_MOT_MAXDUTY_SET : -u);
+	motor.traj.saturated = 0;
+	if (mag >= motor.out.maxDuty)
+	{
+		mag = motor.out.maxDuty;
+		motor.traj.saturated = 1;
+	}
+	if ((motor.traj.saturated == 0) || ((u >= 0) != (verr >= 0)))
+	{
+		motor.traj.integ += C_TRAJ_KI * verr;
+		if (motor.traj.integ > ((int32_t)motor.out.maxDuty << 8))
+		{
+			motor.traj.integ = (int32_t)motor.out.maxDuty << 8;
+		}
+		else if (motor.traj.integ < -((int32_t)motor.out.maxDuty << 8))
+		{
+			motor.traj.integ = -((int32_t)motor.out.maxDuty << 8);
+		}
+		else
+		{
+		}
+	}
+
+#if C_MOT_POLE_POLAR==0
+	motor.direction = ((u >= 0) == (motor.traj.dir > 0)) ? C_DIR_CW : C_DIR_CCW;
+#else
+	motor.direction = ((u >= 0) == (motor.traj.dir > 0)) ? C_DIR_CCW : C_DIR_CW;
+#endif
+	motor.out.duty = mag;
+
+	return phase;
+}
+/* interpolate between a and b, frac [0..span] */
+static int16_t MotInterpolate(int16_t a, int16_t b, int32_t frac, int32_t span)
+{
+	return (int16_t)(a + ((((int32_t)b - a) * frac) / span));
+}
+/*
+supply voltage compensation, called when the voltage moved by more than C_MOT_VS_HYST
+minDuty keeps the same drive voltage as C_MOT_MINDUTY_SET at C_MOT_VREF, the stall and
+sensor thresholds are interpolated in l_asMotVsTable and held outside of it.
+*/
+static void MotSupplyCompensation(uint16_t voltage)
+{
+	uint16_t v = voltage;
+	uint8_t i = 1u;
+	int32_t frac;
+	int32_t span;
+
+	if (v < l_asMotVsTable[0].voltage)
+	{
+		v = l_asMotVsTable[0].voltage;
+	}
+	else if (v > l_asMotVsTable[C_MOT_VS_POINTS - 1u].voltage)
+	{
+		v = l_asMotVsTable[C_MOT_VS_POINTS - 1u].voltage;
+	}
+	else
+	{
+	}
+	while ((i < (C_MOT_VS_POINTS - 1u)) && (v > l_asMotVsTable[i].voltage))
+	{
+		i++;
+	}
+	frac = v - l_asMotVsTable[i - 1u].voltage;
+	span = l_asMotVsTable[i].voltage - l_asMotVsTable[i - 1u].voltage;
+
+	sensor.thd = MotInterpolate(l_asMotVsTable[i - 1u].sensorThd, l_asMotVsTable[i].sensorThd, frac, span);
+	motor.stall.halfThd = (uint16_t)MotInterpolate((int16_t)l_asMotVsTable[i - 1u].halfThd, (int16_t)l_asMotVsTable[i].halfThd, frac, span);
+	motor.stall.threshold = (uint16_t)MotInterpolate((int16_t)l_asMotVsTable[i - 1u].stallThd, (int16_t)l_asMotVsTable[i].stallThd, frac, span);
+	motor.out.minDuty = (uint16_t)(((uint32_t)(uint16_t)C_MOT_MINDUTY_SET * C_MOT_VREF) / v);
+	motor.supply.voltage = voltage;
+}
+/*
+operating point of the learned brake distance: direction, supply voltage band, temperature band
+*/
+static uint8_t MotBrakeBin(void)
+{
+	uint16_t voltage = get_valve_voltage();
+	uint8_t bin = 0u;
+
+	if (voltage >= C_BRAKE_V_HIGH)
+	{
+		bin = 2u * C_BRAKE_TBINS;
+	}
+	else if (voltage >= C_BRAKE_V_LOW)
+	{
+		bin = C_BRAKE_TBINS;
+	}
+	else
+	{
+	}
+	if ((get_valve_temperature() - (int16_t)C_TEMP_CONV_OFFSET) >= C_BRAKE_T_COLD)
+	{
+		bin += 1u;
+	}
+	if (motor.direction == C_DIR_CCW)
+	{
+		bin += C_BRAKE_VBINS * C_BRAKE_TBINS;
+	}
+	return bin;
+}
+/*
+soft-stop threshold of a new move: the learned brake distance plus the creep margin
+*/
+static uint16_t MotBrakeThreshold(uint8_t bin)
+{
+	uint16_t thd = C_BRAKE_DEFAULT;
+
+	if (motor.brake.dist[bin] != 0)
+	{
+		thd = (uint16_t)(motor.brake.dist[bin] + C_BRAKE_MARGIN);
+	}
+	return thd;
+}
+/*
+brake distance learner, 1msec, duty ramp only
+A measurement starts when DEC is entered from RUNNING and ends when the speed dropped below
+sensor.thd, the creep speed of the DEC phase. When the target is reached first the rotor is
+followed into FINE and STOPPED, the coast beyond the target then counts to the brake distance.
+The distance is averaged with 1/4 per move and written to EEPROM while the motor stands,
+only when it moved a full EEPROM step away from the stored one.
+*/
+static void MotBrakeLearn(void)
+{
+	int16_t speed = (motor.speed >= 0) ? motor.speed : -motor.speed;
+	int32_t travel;
+	int16_t dist;
+	int16_t stored;
+
+	if (motor.brake.measure == 0u)
+	{
+	}
+	else if (((motor.state != MOTION_DEC) && (motor.state != MOTION_FINE) && (motor.state != MOTION_STOPPED)) || (motor.stall.flag != 0u) || (motor.fault.flag != 0u) || (motor.brake.time >= C_BRAKE_TIMEOUT))
+	{
+		motor.brake.measure = 0u;
+	}
+	else
+	{
+		motor.brake.time++;
+		if ((((int32_t)speed * C_SENSOR_WINDOW_MS) / 1000) < sensor.thd)
+		{
+			motor.brake.slowCnt++;
+		}
+		else
+		{
+			motor.brake.slowCnt = 0u;
+		}
+		if (motor.brake.slowCnt >= C_BRAKE_SLOW_MS)
+		{
+			motor.brake.measure = 0u;
+			travel = motor.pos.contCurrent - motor.brake.start;
+			if (travel < 0)
+			{
+				travel = -travel;
+			}
+			if (travel < C_BRAKE_MIN)
+			{
+				travel = C_BRAKE_MIN;
+			}
+			else if (travel > C_BRAKE_MAX)
+			{
+				travel = C_BRAKE_MAX;
+			}
+			else
+			{
+			}
+			dist = motor.brake.dist[motor.brake.bin];
+			if (dist == 0)
+			{
+				dist = (int16_t)travel;
+			}
+			else
+			{
+				dist += (int16_t)((travel - dist) / 4);
+			}
+			motor.brake.dist[motor.brake.bin] = dist;
+
+			stored = (int16_t)motor.brake.table.dist[motor.brake.bin] * C_BRAKE_NV_UNIT;
+			if ((dist >= (stored + C_BRAKE_NV_UNIT)) || ((dist + C_BRAKE_NV_UNIT) <= stored))
+			{
+				motor.brake.table.dist[motor.brake.bin] = (uint8_t)((dist + (C_BRAKE_NV_UNIT / 2)) / C_BRAKE_NV_UNIT);
+				motor.brake.store = 1u;
+			}
+		}
+	}
+	if ((motor.brake.store != 0u) && (motor.brake.measure == 0u) && (motor.state == MOTION_STOPPED))
+	{
+		motor.brake.store = 0u;
+		(void)eeprom_WriteBrakeTable(&motor.brake.table);
+	}
+}
+/*
+active brake in DEC, duty ramp only
+The rotor is braked as long as it is faster than the approach speed: the creep speed of
+sensor.thd at the target, rising with C_MOT_BRAKE_KV per remaining travel. Not during the
+calibration, the end-stop model expects a driven motor.
+*/
+static uint16_t MotBrakeStrength(uint16_t diff)
+{
+	int32_t speed = (motor.speed >= 0) ? motor.speed : -motor.speed;
+	int32_t excess;
+	uint16_t strength = 0u;
+
+	excess = speed - ((((int32_t)sensor.thd * 1000) / C_SENSOR_WINDOW_MS) + ((int32_t)C_MOT_BRAKE_KV * diff));
+	if ((excess > 0) && (get_valve_mode() != VALVE_CALIBRATION))
+	{
+		excess *= C_MOT_BRAKE_KS;
+		strength = (excess >= C_PWMOUT_MAX_DUTY) ? C_PWMOUT_MAX_DUTY : (uint16_t)excess;
+	}
+	return strength;
+}
+/*
+rotor speed of the motor model, (duty * Vs - I * R(T)) / Ke [0.1deg/s]
+*/
+static int32_t MotEmfSpeed(uint16_t voltage, uint16_t current)
+{
+	int16_t temperature = get_valve_temperature() - (int16_t)C_TEMP_CONV_OFFSET;
+	int32_t resistance;
+	int32_t emf;
+
+	resistance = (int32_t)motor.model.r25 + (((int32_t)motor.model.r25 * (int32_t)motor.model.rTc * (temperature - 25)) >> 16);
+	emf = ((int32_t)motor.out.duty * voltage * 10) / C_PWMOUT_MAX_DUTY;	/* [mV] */
+	emf -= ((int32_t)current * resistance) / 1000;
+	return (emf * 10) / (int32_t)motor.model.ke;
+}
+/*
+temperature band of the learned breakaway duty
+*/
+static uint8_t MotBreakawayBin(void)
+{
+	int16_t t = (get_valve_temperature() - (int16_t)C_TEMP_CONV_OFFSET) - C_BREAKAWAY_T_MIN;
+	uint8_t bin = 0u;
+
+	if (t > 0)
+	{
+		bin = (uint8_t)(t / C_BREAKAWAY_T_STEP);
+		if (bin >= C_BREAKAWAY_TBINS)
+		{
+			bin = C_BREAKAWAY_TBINS - 1u;
+		}
+	}
+	return bin;
+}
+/*
+learned breakaway duty of the temperature band at the supply voltage, 0 when not learned
+*/
+static uint32_t MotBreakawayDuty(uint8_t bin)
+{
+	uint32_t learned = motor.breakaway.duty[bin];
+
+	if ((learned != 0u) && (motor.supply.voltage != 0u))
+	{
+		learned = (learned * C_MOT_VREF) / motor.supply.voltage;
+	}
+	else
+	{
+		learned = 0u;
+	}
+	return learned;
+}
+/*
+start duty of a ramp from rest: C_BREAKAWAY_MARGIN ramp steps below the learned breakaway duty
+at the supply voltage, C_MOT_STARTDUTY_SET when not learned
+*/
+static uint16_t MotBreakawayStart(void)
+{
+	uint16_t duty = C_MOT_STARTDUTY_SET;
+	uint16_t margin = C_BREAKAWAY_MARGIN * motor.softStart.accDuty;
+	uint32_t learned = MotBreakawayDuty(motor.breakaway.bin);
+
+	if (learned > ((uint32_t)duty + margin))
+	{
+		duty = (uint16_t)(learned - margin);
+	}
+	if (duty > motor.out.maxDuty)
+	{
+		duty = motor.out.maxDuty;
+	}
+	return duty;
+}
+/*
+breakaway duty learner, 1msec, duty ramp only
+The winding current of a standing rotor follows the duty, the back-EMF model speed stays at a
+floor. The model speed rises C_BREAKAWAY_EMF above the floor C_BREAKAWAY_LAG ramp steps after the
+breakaway duty; it is normalised to C_MOT_VREF, averaged with 1/4 per start and written to EEPROM while the
+motor stands, only when it moved a full EEPROM step away from the stored one.
+The valve angle cannot detect it, the gearbox play is taken up before the valve moves.
+*/
+static void MotBreakawayLearn(uint16_t voltage)
+{
+	uint16_t current = get_valve_motCurrent();
+	int32_t speed;
+	uint32_t duty;
+	uint16_t learned;
+	uint16_t stored;
+
+	if (motor.breakaway.measure == 0u)
+	{
+	}
+	else if ((motor.state != MOTION_ACC) || (motor.stall.flag != 0u) || (motor.fault.flag != 0u))
+	{
+		motor.breakaway.measure = 0u;
+	}
+	else if (current >= C_BREAKAWAY_I_MIN)
+	{
+		speed = MotEmfSpeed(voltage, current);
+		if (speed < motor.breakaway.floor)
+		{
+			motor.breakaway.floor = speed;
+		}
+		else if (speed >= (motor.breakaway.floor + C_BREAKAWAY_EMF))
+		{
+			motor.breakaway.measure = 0u;
+			duty = C_BREAKAWAY_LAG * motor.softStart.accDuty;
+			duty = (motor.out.duty > duty) ? (motor.out.duty - duty) : 0u;
+			duty = (duty * voltage) / C_MOT_VREF;
+			if (duty > C_BREAKAWAY_MAX)
+			{
+				duty = C_BREAKAWAY_MAX;
+			}
+			learned = motor.breakaway.duty[motor.breakaway.bin];
+			if (learned == 0u)
+			{
+				learned = (uint16_t)duty;
+			}
+			else
+			{
+				learned = (uint16_t)((int32_t)learned + (((int32_t)duty - (int32_t)learned) / 4));
+			}
+			motor.breakaway.duty[motor.breakaway.bin] = learned;
+
+			stored = (uint16_t)motor.breakaway.table.duty[motor.breakaway.bin] * C_BREAKAWAY_NV_UNIT;
+			if ((learned >= (stored + C_BREAKAWAY_NV_UNIT)) || ((learned + C_BREAKAWAY_NV_UNIT) <= stored))
+			{
+				motor.breakaway.table.duty[motor.breakaway.bin] = (uint8_t)((learned + (C_BREAKAWAY_NV_UNIT / 2u)) / C_BREAKAWAY_NV_UNIT);
+				motor.breakaway.store = 1u;
+			}
+		}
+		else
+		{
+		}
+	}
+	else
+	{
+	}
+	if ((motor.breakaway.store != 0u) && (motor.state == MOTION_STOPPED))
+	{
+		motor.breakaway.store = 0u;
+		(void)eeprom_WriteBreakawayTable(&motor.breakaway.table);
+	}
+}
+/*
+gearbox play measurement, 1msec, armed by MotMeasureBacklash()
+The motor runs through the play before the valve follows: the play is the travel of the
+back-EMF model until the valve moved C_BACKLASH_ONSET, minus that valve travel. The model is
+scaled by the valve travel from there on to C_BACKLASH_TRAVEL, which cancels a Ke error; an
+R error is not cancelled. A measurement is dropped when the current rises again after its
+peak (the load changed), when the model speed at the end is below C_BACKLASH_SPEED_MIN or
+when the play is implausible, the others average with the play so far.
+*/
+static void MotBacklashLearn(uint16_t voltage)
+{
+	uint16_t current = get_valve_motCurrent();
+	int32_t speed;
+	int32_t moved;
+	int32_t play;
+
+	if (motor.backlash.measure == 0u)
+	{
+	}
+	else if ((motor.state < MOTION_ACC) || (motor.state > MOTION_DEC) || (motor.stall.flag != 0u) || (motor.fault.flag != 0u))
+	{
+		motor.backlash.measure = 0u;
+	}
+	else if (current < C_BREAKAWAY_I_MIN)
+	{
+	}
+	else if ((motor.backlash.peak != 0u) && (current > (motor.backlash.current + C_BACKLASH_I_NOISE)))
+	{
+		/* the load changed on the way, the model travel is off */
+		motor.backlash.measure = 0u;
+	}
+	else
+	{
+		if (motor.backlash.peak == 0u)
+		{
+			if (current > motor.backlash.current)
+			{
+				motor.backlash.current = current;
+			}
+			else if ((current + C_BACKLASH_I_NOISE) < motor.backlash.current)
+			{
+				motor.backlash.peak = 1u;
+				motor.backlash.current = current;
+			}
+			else
+			{
+			}
+		}
+		else if (current < motor.backlash.current)
+		{
+			motor.backlash.current = current;
+		}
+		else
+		{
+		}
+		speed = MotEmfSpeed(voltage, current);
+		motor.backlash.travel += speed;
+		moved = motor.pos.contCurrent - motor.backlash.start;
+		if (moved < 0)
+		{
+			moved = -moved;
+		}
+		if ((motor.backlash.onsetMoved == 0) && (moved >= (int32_t)C_BACKLASH_ONSET))
+		{
+			motor.backlash.onset = motor.backlash.travel;
+			motor.backlash.onsetMoved = (int16_t)moved;
+		}
+		if (moved >= (int32_t)C_BACKLASH_TRAVEL)
+		{
+			motor.backlash.measure = 0u;
+			if ((speed >= C_BACKLASH_SPEED_MIN) && (motor.backlash.travel > motor.backlash.onset))
+			{
+				play = (motor.backlash.onset * (moved - motor.backlash.onsetMoved)) / (motor.backlash.travel - motor.backlash.onset);
+				play -= motor.backlash.onsetMoved;
+				if ((play >= 0) && (play <= (int32_t)C_BACKLASH_MAX))
+				{
+					motor.backlash.play = (int16_t)((motor.backlash.play + play + 1) / 2);
+				}
+			}
+		}
+	}
+}
+/*
+coast of a rotor driven towards the target once the output stops, 100usec
+The stop brake decays the speed with the time constant tau: the coast is speed * tau. Only
+moves of ACC, RUNNING and DEC are predicted, not the calibration, it has to reach the end
+stops, nor rotors slower than C_COAST_SPEED_MIN: -1.
+*/
+static int16_t MotCoastPredict(void)
+{
+	int32_t speed = (motor.pos.Delta >= 0) ? motor.speed : -motor.speed;
+	int16_t coast = -1;
+
+	if ((motor.out.enable != 0u) && (motor.ctrl.mode == C_MOT_CTRL_RAMP) && (motor.state >= MOTION_ACC) && (motor.state <= MOTION_DEC) && (speed >= C_COAST_SPEED_MIN) && (get_valve_mode() != VALVE_CALIBRATION))
+	{
+		coast = (int16_t)((speed * motor.coast.tau) >> 10);
+	}
+	return coast;
+}
+/*
+coast measurement of a cut-off, started by motor_ctrl_handler()
+The coast ends when the speed dropped below sensor.thd, or is abandoned when the output is
+switched on again (FINE pulse, reversal, new move). The coast and the resting error are
+logged, tau is averaged with 1/4 of the measured time constant.
+*/
+static void MotCoastLearn(void)
+{
+	int16_t speed = (motor.speed >= 0) ? motor.speed : -motor.speed;
+	int32_t travel;
+	int32_t tau;
+
+	if (motor.coast.measure == 0u)
+	{
+	}
+	else if ((motor.out.enable != 0u) || (motor.stall.flag != 0u) || (motor.fault.flag != 0u) || (motor.coast.time >= C_COAST_TIMEOUT))
+	{
+		motor.coast.measure = 0u;
+	}
+	else
+	{
+		motor.coast.time++;
+		if ((((int32_t)speed * C_SENSOR_WINDOW_MS) / 1000) < sensor.thd)
+		{
+			motor.coast.slowCnt++;
+		}
+		else
+		{
+			motor.coast.slowCnt = 0u;
+		}
+		if (motor.coast.slowCnt >= C_COAST_SLOW_MS)
+		{
+			motor.coast.measure = 0u;
+			travel = motor.pos.contCurrent - motor.coast.start;
+			if (motor.coast.target < motor.coast.start)
+			{
+				travel = -travel;
+			}
+			/* a rotor that sprang back did not coast */
+			tau = (travel > 0) ? ((travel * 1024) / motor.coast.speed) : 0;
+			tau = motor.coast.tau + ((tau - motor.coast.tau) / 4);
+			if (tau > C_COAST_TAU_MAX)
+			{
+				tau = C_COAST_TAU_MAX;
+			}
+			motor.coast.tau = (int16_t)tau;
+			motor.coast.log.speed = motor.coast.speed;
+			motor.coast.log.predicted = motor.coast.predicted;
+			motor.coast.log.coast = (int16_t)travel;
+			motor.coast.log.restError = (int16_t)(motor.coast.target - motor.pos.contCurrent);
+			if (motor.coast.target < motor.coast.start)
+			{
+				motor.coast.log.restError = -motor.coast.log.restError;
+			}
+			motor.coast.log.tau = motor.coast.tau;
+			motor.coast.log.count++;
+		}
+	}
+}
 static uint16_t Mot_dirChange_check(void)
 {
 	uint16_t flag=0;
@@ -317,6 +1277,41 @@ u16EventValue|=(uint16_t)((motor.elapsedTime>>8)<<8);
 	}
 }
 
+/*
+end-stop detector, 1msec, armed by MotSetEndStopConfirm() during calibration
+The rotor is blocked when the observer speed is low and the back-EMF left over by the
+motor model, duty * Vs - I * R(T), is low as well: a frozen angle with a running motor
+or a slow motor at low duty are no end-stop. A rising current confirms twice as fast.
+*/
+static void MotEndStopDiag(uint16_t voltage)
+{
+	uint16_t current = get_valve_motCurrent();
+	int16_t rise = (int16_t)(current - motor.endStop.current[motor.endStop.idx]);
+
+	motor.endStop.current[motor.endStop.idx] = current;
+	motor.endStop.idx = (motor.endStop.idx + 1u) & (C_ENDSTOP_RISE_MS - 1u);
+
+	if ((motor.endStop.confirm == 0u) || (get_valve_mode() != VALVE_CALIBRATION) || (motor.out.enable == 0) || (sensor.delay != 0))
+	{
+		motor.endStop.count = 0;
+	}
+	else
+	{
+		if ((motor.speed < C_ENDSTOP_SPEED) && (motor.speed > -C_ENDSTOP_SPEED) && (MotEmfSpeed(voltage, current) < C_ENDSTOP_EMF_SPEED))
+		{
+			motor.endStop.count += (rise >= C_ENDSTOP_RISE) ? 2u : 1u;
+		}
+		else
+		{
+			motor.endStop.count = 0;
+		}
+		if (motor.endStop.count >= motor.endStop.confirm)
+		{
+			motor.stall.flag |= STALL_MASK_ENDSTOP;
+		}
+	}
+}
+
 /**
  * \brief Motor electric diagnostic
  *
@@ -385,20 +1380,72 @@ u16EventValue|=(uint16_t)((motor.elapsedTime>>8)<<8);
 	{
 		motor.fault.flag |= FAULT_MASK_PHASE_A_SHORT;
 
-u16EventState=MOT_SHORT_FAULT;		
-u16EventValue=(uint16_t)(current>>3);
-u16EventValue|=(uint16_t)((motor.elapsedTime>>8)<<8);				
+u16EventState=MOT_SHORT_FAULT;		
+u16EventValue=(uint16_t)(current>>3);
+u16EventValue|=(uint16_t)((motor.elapsedTime>>8)<<8);				
+	}
+	else if (g_e8OverCurrent != 0)
+	{
+		motor.fault.flag |= FAULT_MASK_OVER_CURRENT;
+	}
+	else
+	{
+
+	}
+}
+
+/* set the direction from Delta and start the bridge */
+static void MotSetDirection(void)
+{
+#if C_MOT_POLE_POLAR==0		
+	if (motor.pos.Delta > 0)
+#else
+	if (motor.pos.Delta < 0)
+#endif
+	{
+		motor.direction=C_DIR_CW;
+	}
+	else
+	{
+		motor.direction=C_DIR_CCW;
+	}
+	pwm_Start(motor.direction,0u);		
+}
+/*
+start a move towards the target, from standstill or after the brake of a reversal
+return : MOTION_RUNNING for the PID loop, MOTION_ACC otherwise
+*/
+static tMotState MotStartMove(void)
+{
+	tMotState next_state = MOTION_ACC;
+
+	MotSetDirection();
+	if (motor.ctrl.mode == C_MOT_CTRL_PID)
+	{
+		next_state = MOTION_RUNNING;
 	}
-	else if (g_e8OverCurrent != 0)
+	else if (motor.ctrl.mode == C_MOT_CTRL_SCURVE)
 	{
-		motor.fault.flag |= FAULT_MASK_OVER_CURRENT;
+		MotTrajectoryInit();
 	}
 	else
 	{
-
+		motor.brake.bin = MotBrakeBin();
+		motor.softStop.inThreshold = MotBrakeThreshold(motor.brake.bin);
 	}
+	return next_state;
+}
+/*
+target moved behind the rotor during a ramp move: DEC brakes it instead of a pause in
+PAUSE, the brake distance of this move is not learned
+*/
+static void MotReverseStart(void)
+{
+	motor.reverse.active=1u;
+	motor.reverse.slowCnt=0;
+	motor.reverse.time=0;
+	motor.brake.measure=0u;
 }
-
 static tMotState motor_state_INIT (void)
 {
 	tMotState next_state = MOTION_INIT;
@@ -412,6 +1459,83 @@ static tMotState motor_state_INIT (void)
 	return next_state;
 }
 
+/*
+largest error that fine positioning corrects [0.1deg]: C_MOT_FINE_RANGE, on the approach plus
+the learned play the rotor turns before the valve follows
+*/
+static uint16_t MotFineReach(void)
+{
+	uint16_t reach = (uint16_t)C_MOT_FINE_RANGE;
+
+	if (motor.backlash.load != 0u)
+	{
+		reach += (uint16_t)motor.backlash.play;
+	}
+	return reach;
+}
+/*
+error that fine positioning corrects: from C_MOT_FINE_DEADBAND up to MotFineReach()
+*/
+static uint8_t MotFineRange(void)
+{
+	int16_t diff = (motor.pos.Delta >= 0) ? motor.pos.Delta : -motor.pos.Delta;
+
+	return (uint8_t)((diff >= (int16_t)C_MOT_FINE_DEADBAND) && (diff <= (int16_t)MotFineReach()) && (get_valve_mode() != VALVE_CALIBRATION));
+}
+/*
+the rotor stays within the dead band even when it kept its speed for another sensor window
+*/
+static uint8_t MotFineSettled(uint16_t diff)
+{
+	int32_t travel = ((int32_t)motor.speed * C_SENSOR_WINDOW_MS) / 1000;
+
+	if (travel < 0)
+	{
+		travel = -travel;
+	}
+	return (uint8_t)((travel + diff) < (int32_t)C_MOT_FINE_DEADBAND);
+}
+/*
+target reached: a rotor still turning is followed in FINE, it may coast out of the hysteresis
+Past the target of an approach the move reverses onto the target itself, in FINE when the
+error with the play is within its reach. A stop keeps the target for the next move.
+*/
+static tMotState MotReachedState(void)
+{
+	tMotState next_state = MOTION_STOPPED;
+
+	if (motor.backlash.approach != 0u)
+	{
+		motor.backlash.approach = 0u;
+		motor.backlash.load = 1u;
+		motor.pos.contTarget = motor.backlash.final;
+		motor.pos.Delta = (int16_t)(motor.pos.contTarget - motor.pos.contCurrent);
+		motor.pos.posReached = 0;
+		if (motor.requestStop != 0)
+		{
+		}
+		else if (motor.ctrl.mode == C_MOT_CTRL_RAMP)
+		{
+			MotReverseStart();
+			next_state = MOTION_DEC;
+		}
+		else if (MotFineRange() != 0u)
+		{
+			next_state = MOTION_FINE;
+		}
+		else
+		{
+			/* the PID loop keeps its state, the S-curve starts a new profile */
+			motor.out.enable = 1;
+			next_state = MotStartMove();
+		}
+	}
+	else if ((motor.requestStop == 0) && ((motor.speed >= C_MOT_REVERSE_SPEED) || (motor.speed <= -C_MOT_REVERSE_SPEED)) && (get_valve_mode() != VALVE_CALIBRATION))
+	{
+		next_state = MOTION_FINE;
+	}
+	return next_state;
+}
 static tMotState motor_state_STOPPED(void)
 {
 	tMotState next_state = MOTION_STOPPED;
@@ -425,6 +1549,8 @@ static tMotState motor_state_STOPPED(void)
 	motor.out.enable=0;
 	motor.out.duty=0;
 	motor.pos.posReached = 0;
+	motor.reverse.active = 0u;
+	motor.backlash.load = 0u;
 	if (motor.requestStop != 0)
 	{
 
@@ -432,29 +1558,158 @@ static tMotState motor_state_STOPPED(void)
 	else if (motor.pos.newTarget)
 	{
 		motor.pos.newTarget=0;
-#if C_MOT_POLE_POLAR==0		
-		if (motor.pos.Delta > 0)
-#else
-		if (motor.pos.Delta < 0)
-#endif
+		rState=1;
+	}
+	else
+	{
+
+	}
+
+	if (rState != 0)
+	{
+		/* a small correction does not need a full ramp */
+		if (MotFineRange() != 0u)
 		{
-			motor.direction=C_DIR_CW;
+			next_state = MOTION_FINE;
 		}
 		else
 		{
-			motor.direction=C_DIR_CCW;
+			next_state = MotStartMove();
 		}
-		rState=1;
 	}
-	else
-	{
+	return next_state;
+}
+/*
+valve travel of the last FINE pulse towards the target [0.1deg], on the observer angle: a
+single sensor reading may be off by more than C_MOT_FINE_MOVED
+*/
+static int32_t MotFineMoved(void)
+{
+	int32_t moved = motor.obs.posInt - motor.fine.start;
+
+	return (motor.fine.lastDelta >= 0) ? moved : -moved;
+}
+/*
+fine positioning, all controller modes
+Entered at the end of a move while the rotor still turns, or for a small new target. A rotor
+standing C_MOT_FINE_DEADBAND or more off the target gets pulses towards it. From
+C_MOT_FINE_PULSE_MS on a pulse ends as soon as the valve moved C_MOT_FINE_MOVED towards the
+target, the gearbox play may have to be taken up first. The rotor is braked and has to stand before the next pulse.
+The pulse duty is the learned breakaway duty of the ramp at the supply voltage, at least minDuty,
+plus C_MOT_FINE_GAIN per remaining error. On the approach of a move the error counts the
+learned play as well until the valve followed a pulse. Within the correction a pulse that did
+not move raises it by C_MOT_FINE_STEP, a pulse that crossed the target lowers it again.
+Ends standing within the dead band, or after C_MOT_FINE_PULSES pulses.
+*/
+static tMotState motor_state_FINE(void)
+{
+	tMotState next_state = MOTION_FINE;
+	int32_t moved;
+	int32_t duty;
+	int32_t error;
+	uint16_t diff;
 
+	if(motor.initStatus)
+	{
+		motor.initStatus=0;
+		motor.fine.pulses=0;
+		motor.fine.pulse=0;
+		motor.fine.time=0;
+		motor.fine.base=(int16_t)MotBreakawayDuty(MotBreakawayBin());
+		if (motor.fine.base < (int16_t)motor.out.minDuty)
+		{
+			motor.fine.base = (int16_t)motor.out.minDuty;
+		}
+		motor.fine.trim=0;
 	}
 
-	if (rState != 0)
+	diff = (motor.pos.Delta >= 0) ? motor.pos.Delta : -motor.pos.Delta;
+	motor.pos.posReached = 0;
+	if (motor.pos.newTarget != 0)
 	{
-		pwm_Start(motor.direction,0u);		
-		next_state = MOTION_ACC;
+		motor.pos.newTarget=0;
+		motor.fine.pulses=0;
+	}
+	if ((motor.requestStop != 0) || (get_valve_mode() == VALVE_CALIBRATION))
+	{
+		next_state = MOTION_STOPPED;
+	}
+	else if (diff > MotFineReach())
+	{
+		/* new target further away, or the rotor coasted out of the range */
+		next_state = MotStartMove();
+	}
+	else if (motor.fine.pulse != 0u)
+	{
+		moved = MotFineMoved();
+		motor.fine.time++;
+		if ((motor.out.enable == 0) || ((motor.fine.time >= C_MOT_FINE_PULSE_MS) && (moved >= C_MOT_FINE_MOVED)) || (motor.fine.time >= C_MOT_FINE_PULSE_MAX))
+		{
+			/* the hysteresis was reached, the valve moved or the pulse timed out */
+			motor.out.enable=0;
+			motor.fine.pulse=0u;
+			motor.fine.time=0;
+		}
+	}
+	else
+	{
+		motor.out.enable=0;
+		if ((motor.speed < C_MOT_REVERSE_SPEED) && (motor.speed > -C_MOT_REVERSE_SPEED))
+		{
+			motor.fine.time++;
+		}
+		else
+		{
+			motor.fine.time=0;
+		}
+		if ((motor.fine.time >= C_MOT_FINE_SETTLE_MS) || (MotFineSettled(diff) != 0u))
+		{
+			/* standing, or certain to stop within the dead band */
+			if (motor.fine.pulses != 0u)
+			{
+				if (MotFineMoved() >= C_MOT_FINE_MOVED)
+				{
+					/* the valve followed, the play is taken up */
+					motor.backlash.load = 0u;
+				}
+				if ((MotFineMoved() < C_MOT_FINE_MOVED) && (motor.out.duty < motor.out.maxDuty))
+				{
+					motor.fine.trim += C_MOT_FINE_STEP;
+				}
+				else if (((motor.pos.Delta ^ motor.fine.lastDelta) < 0) && (motor.fine.trim >= C_MOT_FINE_STEP))
+				{
+					motor.fine.trim -= C_MOT_FINE_STEP;
+				}
+				else
+				{
+				}
+			}
+			if ((diff < (uint16_t)C_MOT_FINE_DEADBAND) || (motor.fine.pulses >= C_MOT_FINE_PULSES))
+			{
+				next_state = MOTION_STOPPED;
+			}
+			else
+			{
+				error = diff;
+				if (motor.backlash.load != 0u)
+				{
+					error += motor.backlash.play;
+				}
+				duty = (int32_t)motor.fine.base + motor.fine.trim + ((int32_t)C_MOT_FINE_GAIN * error);
+				if (duty > (int32_t)motor.out.maxDuty)
+				{
+					duty = motor.out.maxDuty;
+				}
+				MotSetDirection();
+				motor.out.duty=(uint16_t)duty;
+				motor.out.enable=1;
+				motor.fine.start=motor.obs.posInt;
+				motor.fine.lastDelta=motor.pos.Delta;
+				motor.fine.pulses++;
+				motor.fine.pulse=1u;
+				motor.fine.time=0;
+			}
+		}
 	}
 	return next_state;
 }
@@ -472,12 +1727,37 @@ static tMotState motor_state_ACC (void)/*20250714*/
 	{
 		motor.initStatus=0;
 		motor.out.enable=1;
-		motor.out.duty=C_MOT_STARTDUTY_SET;
+		if ((motor.out.duty < C_MOT_STARTDUTY_SET) && (motor.speed < C_MOT_REVERSE_SPEED) && (motor.speed > -C_MOT_REVERSE_SPEED))
+		{
+			/* start from rest: just below the learned breakaway duty, measure it again */
+			motor.breakaway.bin = MotBreakawayBin();
+			motor.out.duty = MotBreakawayStart();
+			motor.breakaway.measure = 1u;
+			motor.breakaway.floor = INT32_MAX;
+			motor.backlash.measure = motor.backlash.arm;
+			motor.backlash.arm = 0u;
+			motor.backlash.start = motor.pos.contCurrent;
+			motor.backlash.travel = 0;
+			motor.backlash.onsetMoved = 0;
+			motor.backlash.current = 0u;
+			motor.backlash.peak = 0u;
+		}
+		else if (motor.out.duty < C_MOT_STARTDUTY_SET)
+		{
+			/* rotor still turning after a reversal */
+			motor.out.duty=C_MOT_STARTDUTY_SET;
+		}
+		/* else: target moved further away during DEC, accelerate from the current duty */
 	}
 
 	if ((motor.requestStop != 0) || (motor.pos.posReached != 0))
 	{
-		next_state = MOTION_STOPPED;
+		next_state = MotReachedState();
+	}
+	else if (Mot_dirChange_check() != 0)
+	{
+		MotReverseStart();
+		next_state = MOTION_DEC;
 	}
 	else 
 	{
@@ -551,11 +1831,12 @@ static tMotState motor_state_RUNNING (void)
 	if ((motor.requestStop != 0) || (motor.pos.posReached != 0))
 	{
 
-		next_state = MOTION_STOPPED;
+		next_state = MotReachedState();
 	}
 	else if (Mot_dirChange_check() != 0)
 	{
-		next_state = MOTION_PAUSE;
+		MotReverseStart();
+		next_state = MOTION_DEC;
 	}
 #if 0	
 	else if (motor.elapsedTime > motor.runTimeOut)
@@ -596,17 +1877,60 @@ static tMotState motor_state_DCC (void)
 		motor.initStatus=0;
 		motor.out.enable=1;
 		motor.softStop.completed=0;
+		if ((motor.lastState == MOTION_RUNNING) && (motor.reverse.active == 0u) && (get_valve_mode() != VALVE_CALIBRATION))
+		{
+			/* braking from the cruise speed, calibration moves end at the stoppers */
+			motor.brake.measure=1u;
+			motor.brake.start=motor.pos.contCurrent;
+			motor.brake.time=0;
+			motor.brake.slowCnt=0;
+		}
 	}
 	
 	if ((motor.requestStop != 0) || (motor.pos.posReached != 0))
 	{
 
-		next_state = MOTION_STOPPED;
+		next_state = MotReachedState();
+	}
+	else if (motor.reverse.active != 0u)
+	{
+		/* reversal: short brake, start the other way as soon as the rotor stands */
+		motor.out.enable=0;
+		motor.out.duty=0;
+		if ((motor.speed < C_MOT_REVERSE_SPEED) && (motor.speed > -C_MOT_REVERSE_SPEED))
+		{
+			motor.reverse.slowCnt++;
+		}
+		else
+		{
+			motor.reverse.slowCnt=0;
+		}
+		motor.reverse.time++;
+		if ((motor.reverse.slowCnt >= C_MOT_REVERSE_MS) || (motor.reverse.time >= C_MOT_REVERSE_TIMEOUT))
+		{
+			motor.reverse.active=0u;
+			if (MotFineRange() != 0u)
+			{
+				next_state = MOTION_FINE;
+			}
+			else if ((motor.pos.Delta > (int16_t)C_MOT_ON_HYSTERISYS) || (motor.pos.Delta < -(int16_t)C_MOT_ON_HYSTERISYS))
+			{
+				next_state = MotStartMove();
+			}
+			else
+			{
+				next_state = MOTION_STOPPED;
+			}
+		}
 	}
 	else if (Mot_dirChange_check() != 0)
 	{
-		next_state = MOTION_PAUSE;
-		
+		MotReverseStart();
+	}
+	else if ((motor.pos.Delta > (int16_t)(motor.softStop.inThreshold + C_MOT_ON_HYSTERISYS)) || (motor.pos.Delta < -(int16_t)(motor.softStop.inThreshold + C_MOT_ON_HYSTERISYS)))
+	{
+		/* target moved further away in the same direction */
+		next_state = MOTION_ACC;
 	}
 	else
 	{
@@ -636,17 +1960,61 @@ static tMotState motor_state_DCC (void)
 
 			}				
 #endif
+			motor.out.brake = MotBrakeStrength(u16diff);
 		}
 		if (sensor.moving==C_STATUS_STOP)
 		{
 		
 			motor.softStop.completed=1;
+			motor.out.brake=0;
 			motor.out.duty += ((u16diff>>1)+motor.softStop.dccDuty);
 		}
 	}
 
 	return next_state;
 }
+/*
+PID mode, runs in MOTION_RUNNING: the loop reverses and slows down by itself
+*/
+static tMotState motor_state_PID (void)
+{
+	tMotState next_state = MOTION_RUNNING;
+
+	if(motor.initStatus)
+	{
+		motor.initStatus=0;
+		motor.out.enable=1;
+		motor.ctrl.integ=0;
+		motor.ctrl.output=0;
+	}
+	MotPositionPid();
+	if ((motor.requestStop != 0) || (motor.pos.posReached != 0))
+	{
+		next_state = MotReachedState();
+	}
+
+	return next_state;
+}
+/*
+S-curve mode, runs in MOTION_ACC/RUNNING/DEC following the phase of the profile
+*/
+static tMotState motor_state_TRAJ (uint16_t voltage)
+{
+	tMotState next_state;
+
+	if(motor.initStatus)
+	{
+		motor.initStatus=0;
+		motor.out.enable=1;
+	}
+	next_state = MotTrajectory(voltage);
+	if ((motor.requestStop != 0) || (motor.pos.posReached != 0))
+	{
+		next_state = MotReachedState();
+	}
+
+	return next_state;
+}
 static tMotState motor_state_PAUSE (void)
 {
 	tMotState next_state = MOTION_PAUSE;
@@ -710,6 +2078,8 @@ DIAGNOSTIC_Reset();
 
 void app_mot_init(void)
 {
+	mot_ctrl_config_t ctrlConfig;
+	mot_model_config_t modelConfig;
 
 	motor.state=MOTION_STOPPED;
 	motor.lastState=MOTION_STOPPED;
@@ -721,12 +2091,86 @@ void app_mot_init(void)
 	motor.pos.target=0;
 	motor.pos.lastTarget=0;
 	motor.pos.current=0;
+	motor.pos.contTarget=0;
+	motor.pos.contCurrent=0;
 	motor.pos.newTarget=0;
 	motor.pos.posReached=0;
+	motor.obs.seeded=0;
+	motor.speed=0;
+	motor.ctrl.mode=C_MOT_CTRL_MODE;
+	motor.ctrl.kp=C_PID_KP;
+	motor.ctrl.ki=C_PID_KI;
+	motor.ctrl.kd=C_PID_KD;
+	motor.ctrl.integ=0;
+	motor.ctrl.output=0;
+	if (eeprom_ReadCtrlConfig(&ctrlConfig))
+	{
+		/* an empty or erased page keeps the build defaults */
+		MotSetCtrlMode(ctrlConfig.mode);
+		if ((ctrlConfig.kp != 0u) && (ctrlConfig.kp != 0xFFFFu))
+		{
+			MotSetPidGains(ctrlConfig.kp, ctrlConfig.ki, ctrlConfig.kd);
+		}
+	}
+	motor.model.r25=C_MOT_R25;
+	motor.model.rTc=C_MOT_R_TC;
+	motor.model.ke=C_MOT_KE;
+	if (eeprom_ReadMotorModel(&modelConfig))
+	{
+		/* a field of an empty or erased page keeps the build default */
+		if ((modelConfig.r25 != 0u) && (modelConfig.r25 != 0xFFFFu))
+		{
+			motor.model.r25 = modelConfig.r25;
+		}
+		if ((modelConfig.rTc != 0u) && (modelConfig.rTc != 0xFFFFu))
+		{
+			motor.model.rTc = modelConfig.rTc;
+		}
+		if ((modelConfig.ke != 0u) && (modelConfig.ke != 0xFFFFu))
+		{
+			motor.model.ke = modelConfig.ke;
+		}
+	}
 	motor.out.enable=0;
 	motor.out.duty=0;
 	motor.out.maxDuty=C_MOT_MAXDUTY_SET;
 	motor.out.minDuty=C_MOT_MINDUTY_SET;
+	motor.out.brake=0;
+	motor.supply.voltage=0;
+	if (eeprom_ReadBrakeTable(&motor.brake.table) == false)
+	{
+		for (uint8_t i = 0u; i < C_BRAKE_BINS; i++)
+		{
+			motor.brake.table.dist[i] = 0u;
+		}
+	}
+	for (uint8_t i = 0u; i < C_BRAKE_BINS; i++)
+	{
+		motor.brake.dist[i] = (int16_t)motor.brake.table.dist[i] * C_BRAKE_NV_UNIT;
+	}
+	if (eeprom_ReadBreakawayTable(&motor.breakaway.table) == false)
+	{
+		for (uint8_t i = 0u; i < C_BREAKAWAY_TBINS; i++)
+		{
+			motor.breakaway.table.duty[i] = 0u;
+		}
+	}
+	for (uint8_t i = 0u; i < C_BREAKAWAY_TBINS; i++)
+	{
+		motor.breakaway.duty[i] = (uint16_t)motor.breakaway.table.duty[i] * C_BREAKAWAY_NV_UNIT;
+	}
+	motor.breakaway.measure = 0u;
+	motor.breakaway.store = 0u;
+	motor.backlash.play = (int16_t)C_BACKLASH_DEFAULT;
+	motor.backlash.approach = 0u;
+	motor.backlash.load = 0u;
+	motor.backlash.arm = 0u;
+	motor.backlash.measure = 0u;
+	motor.coast.tau = C_COAST_TAU_DEFAULT;
+	motor.coast.measure = 0u;
+	motor.coast.log.count = 0u;
+	motor.brake.measure=0u;
+	motor.brake.store=0u;
 	motor.softStart.enable=1u;
 	motor.softStart.outThreshold=(C_MOT_MAXDUTY_SET * 0.9f);	
 #if SOFTSTART_TEST_ENABLE==1
@@ -742,7 +2186,10 @@ void app_mot_init(void)
 #endif	
 	motor.softStop.enable=1u;
 	motor.softStop.completed=0;
-	motor.softStop.inThreshold=(4*C_GMR_ANGLE_SCALE_FACTOR);
+	motor.softStop.inThreshold=C_BRAKE_DEFAULT;
+	motor.reverse.active=0u;
+	motor.fine.base=0;
+	motor.fine.trim=0;
 	motor.softStop.dccDuty=(C_MOT_MAXDUTY_SET * 0.01f);
 
 	motor.stall.flag=0;
@@ -750,6 +2197,9 @@ void app_mot_init(void)
 	motor.stall.maskTimer=0;	
 	motor.stall.threshold=800;	/* 1000mA -> 800mA */
 
+	motor.endStop.confirm=0;
+	motor.endStop.count=0;
+
 	motor.fault.flag=0;
 	motor.fault.openEnable=1;
 	motor.fault.ocEnable=1;
@@ -758,8 +2208,8 @@ void app_mot_init(void)
 
 	sensor.delay=0;
 	sensor.delta=0;
+	sensor.filterCnt=0;
 	sensor.moving=C_STATUS_OFF_;
-	sensor.lastDeg=0;
 }
 
 /* called by every 1ms */
@@ -768,14 +2218,40 @@ void app_motor_task(void)
 	tMotState next_state = motor.state;
 	uint16_t voltage = get_valve_voltage();
 
+	MotBrakeLearn();
+	MotBreakawayLearn(voltage);
+	MotBacklashLearn(voltage);
+	MotCoastLearn();
 /*** state machine control ***/
 	switch( motor.state )
 	{
 		case MOTION_INIT:	{next_state = motor_state_INIT(); break; }
 		case MOTION_STOPPED:	{next_state = motor_state_STOPPED(); break; }
-		case MOTION_ACC:	{next_state = motor_state_ACC(); break; }
-		case MOTION_RUNNING:	{next_state = motor_state_RUNNING(); break; }
-		case MOTION_DEC:	{next_state = motor_state_DCC(); break; }
+		case MOTION_ACC:
+		case MOTION_RUNNING:
+		case MOTION_DEC:
+			if (motor.ctrl.mode == C_MOT_CTRL_PID)
+			{
+				next_state = motor_state_PID();
+			}
+			else if (motor.ctrl.mode == C_MOT_CTRL_SCURVE)
+			{
+				next_state = motor_state_TRAJ(voltage);
+			}
+			else if (motor.state == MOTION_ACC)
+			{
+				next_state = motor_state_ACC();
+			}
+			else if (motor.state == MOTION_RUNNING)
+			{
+				next_state = motor_state_RUNNING();
+			}
+			else
+			{
+				next_state = motor_state_DCC();
+			}
+			break;
+		case MOTION_FINE:	{next_state = motor_state_FINE(); break; }
 		case MOTION_PAUSE:	{next_state = motor_state_PAUSE(); break; }
 		case MOTION_STALL:	{next_state = motor_state_STALLED(); break; }
 		case MOTION_FAULT:	{next_state = motor_state_FAULT(); break; }
@@ -788,90 +2264,42 @@ void app_motor_task(void)
 		motor.lastState = motor.state;
 		motor.state = next_state;
 		motor.initStatus=1u;
+		motor.out.brake=0;
 		motor.elapsedTime = 0;
 	}
 	else
 	{
 		if (motor.elapsedTime < 0xFFFFu) motor.elapsedTime += 1u;
 	}
+	if ((voltage > (motor.supply.voltage + C_MOT_VS_HYST)) || ((voltage + C_MOT_VS_HYST) < motor.supply.voltage))
+	{
+		MotSupplyCompensation(voltage);
+	}
 	if (motor.out.enable != 0)
 	{
 		if (sensor.delay > 0) 
 		{
 			sensor.delay -= 1;
 		}
-		if (sensor.delay == 0)
-		{
-			sensor.filterPeriod += 1;
-		}
-		
-		if (voltage <= 950)
-		{
-			sensor.thd=10;
-			motor.stall.halfThd=550;
-			motor.stall.threshold=650;
-			motor.out.minDuty=(C_MOT_MAXDUTY_SET * 0.35);
-		}			
-		else if (voltage <= 1050)
-		{
-			sensor.thd=11;
-			motor.stall.halfThd=600;
-			motor.stall.threshold=700;
-			motor.out.minDuty=(C_MOT_MAXDUTY_SET * 0.32);
-		}
-		else if (voltage <= 1150)
-		{
-			sensor.thd=12;
-			motor.stall.halfThd=650;
-			motor.stall.threshold=750;
-			motor.out.minDuty=(C_MOT_MAXDUTY_SET * 0.29);
-		}
-		else if (voltage <= 1250)
-		{
-			sensor.thd=14;
-			motor.stall.halfThd=700;
-			motor.stall.threshold=800;
-			motor.out.minDuty=(C_MOT_MAXDUTY_SET * 0.25);
-		}
-		else if (voltage <= 1450)
-		{
-			sensor.thd=16;
-			motor.stall.halfThd=800;
-			motor.stall.threshold=900;
-			motor.out.minDuty=(C_MOT_MAXDUTY_SET * 0.21);
-		}		
-		else
-		{
-			sensor.thd=17;
-			motor.stall.halfThd=900;
-			motor.stall.threshold=1000;
-			motor.out.minDuty=(C_MOT_MAXDUTY_SET * 0.18);
-		}					
 	}
 	else
 	{
 		sensor.delay=50;
-		sensor.filterPeriod= 10;
 		sensor.filterCnt=0;
 		sensor.delta=0;
 		sensor.moving=C_STATUS_OFF_;
-		sensor.lastDeg = motor.pos.current;
 	}
 	
-	if (sensor.filterPeriod >= 20)/*20msec*/
+	if ((motor.out.enable != 0) && (sensor.delay == 0))/*1msec*/
 	{
-
-		sensor.filterPeriod= 0;
-		if (motor.pos.current > sensor.lastDeg)
+		if (motor.speed >= 0)
 		{
-			sensor.delta = motor.pos.current-sensor.lastDeg;
+			sensor.delta = (int16_t)(((int32_t)motor.speed * C_SENSOR_WINDOW_MS) / 1000);
 		}
 		else
 		{
-			sensor.delta = sensor.lastDeg-motor.pos.current;
+			sensor.delta = (int16_t)((-(int32_t)motor.speed * C_SENSOR_WINDOW_MS) / 1000);
 		}
-		
-		sensor.lastDeg = motor.pos.current;
 
 		if (sensor.delta >= sensor.thd) 
 		{
@@ -893,12 +2321,15 @@ void app_motor_task(void)
 		}
 		else {}
 	}
+	MotEndStopDiag(voltage);
 }
 
 /* called by every 100us */
 void motor_ctrl_handler(void)
 {
 	uint16_t diff;
+	int16_t coast;
+	int32_t delta;
 
 	#if LIN_DEBUG_ENABLE
 	g_u16DebugData[0] = motor.pos.target;
@@ -907,10 +2338,25 @@ void motor_ctrl_handler(void)
 	g_u16DebugData[3] = motor.out.duty;
 	#endif
 
+	PROFILER_ENTER(C_PROFILER_ADC_UPDATE);
 	adc_raw_update();
+	PROFILER_EXIT(C_PROFILER_ADC_UPDATE);
+	PROFILER_ENTER(C_PROFILER_GMR_ANGLE);
 	motor.pos.current = calculate_gmr_angle();
+	PROFILER_EXIT(C_PROFILER_GMR_ANGLE);
+	motor.pos.contCurrent = gmr_angle_unwrap(motor.pos.current);
+	MotSpeedObserver();
 
-	motor.pos.Delta = (int16_t)(motor.pos.target-motor.pos.current);
+	delta = motor.pos.contTarget-motor.pos.contCurrent;
+	if (delta > INT16_MAX)
+	{
+		delta = INT16_MAX;
+	}
+	else if (delta < -INT16_MAX)
+	{
+		delta = -INT16_MAX;
+	}
+	motor.pos.Delta = (int16_t)delta;
 	if (motor.pos.Delta >= 0)
 	{
 		diff = motor.pos.Delta;
@@ -920,8 +2366,20 @@ void motor_ctrl_handler(void)
 		diff = -motor.pos.Delta;
 	}
 	
-	if (diff <= (int16_t)C_MOT_OFF_HYSTERISYS)
+	/* predictive cut-off: stop as soon as the coast ends in the target window */
+	coast = MotCoastPredict();
+	if ((diff <= (int16_t)C_MOT_OFF_HYSTERISYS) || ((coast >= 0) && (diff <= (uint16_t)coast)))
 	{
+		if (coast >= 0)
+		{
+			motor.coast.predicted = coast;
+			motor.coast.speed = (motor.pos.Delta >= 0) ? motor.speed : -motor.speed;
+			motor.coast.start = motor.pos.contCurrent;
+			motor.coast.target = motor.pos.contTarget;
+			motor.coast.time = 0u;
+			motor.coast.slowCnt = 0u;
+			motor.coast.measure = 1u;
+		}
 		motor.out.enable=0;
 		motor.pos.posReached = 1;
 		motor.pos.newTarget=0;
@@ -967,9 +2425,15 @@ void motor_ctrl_handler(void)
 
 	if (motor.out.enable)
 	{
+		if (motor.out.brake != 0u)
+		{
+			pwm_Brake(motor.out.brake);
+		}
+		else
+		{
 	/* 16384 = 0% */
-		pwm_SetDutyCycle(motor.direction,motor.out.duty); 
-
+			pwm_SetDutyCycle(motor.direction,motor.out.duty); 
+		}
 	}
 	else
 	{
@@ -979,7 +2443,7 @@ void motor_ctrl_handler(void)
 		}
 		else
 		{
-			pwm_Stop();
+			pwm_Brake(C_MOT_STOP_BRAKE);
 		}
 
 	}
@@ -21,6 +21,7 @@ typedef struct
 
 #define STALL_MASK_TEMPORARY 0x01u
 #define STALL_MASK_PERMENT 0x02u
+#define STALL_MASK_ENDSTOP 0x04u
 
 #define FAULT_MASK_PHASE_A_OPEN 0x01u
 // #define FAULT_MASK_PHASE_B_OPEN             0x02u
@@ -47,6 +48,102 @@ typedef enum
 #define C_MOT_ON_HYSTERISYS (1.0f * C_GMR_ANGLE_SCALE_FACTOR)
 #define C_MOT_OFF_HYSTERISYS (0.3f * C_GMR_ANGLE_SCALE_FACTOR)
 
+/* alpha-beta speed observer, 100us: alpha = 2^-5, beta = 2^-11 (critically damped, ~7ms) */
+#define C_OBS_ALPHA_SHIFT 5u
+#define C_OBS_BETA_SHIFT 11u
+#define C_OBS_RESEED_ERROR (int16_t)(10 * C_GMR_ANGLE_SCALE_FACTOR) /* larger position error re-seeds the observer */
+/* sensor.thd and sensor.delta are given as travel per 20ms [0.1deg] */
+#define C_SENSOR_WINDOW_MS 20
+
+/* supply voltage compensation */
+#define C_MOT_VREF 1200u	/* supply voltage of C_MOT_MINDUTY_SET [10mV], minDuty scales with C_MOT_VREF / Vs */
+#define C_MOT_VS_HYST 10u	/* voltage change that updates the compensation [10mV] */
+
+/* motor model of the back-EMF speed estimate (end-stop detector, breakaway and play learning)
+ * Build defaults: the nominal motor of the host plant model (host_plant.c, 10 Ohm, 0.01 Vs/rad
+ * at the motor, 87 mV per deg/s through the gearbox), not measured on a drive. The data of
+ * the fitted motor, datasheet or bench, goes into EEPROM page 11 (eeprom_ReadMotorModel()). */
+#define C_MOT_R25 10000 /* winding resistance at 25C [mOhm] */
+#define C_MOT_R_TC 256	/* winding resistance temperature coefficient [1/K, Q16], 0.39%/K (copper) */
+#define C_MOT_KE 87		/* back-EMF constant at the valve shaft [mV per deg/s] */
+/* end-stop detector, 1ms */
+#define C_ENDSTOP_SPEED 150		/* observer speed below [0.1deg/s] */
+#define C_ENDSTOP_EMF_SPEED 400 /* back-EMF model speed below [0.1deg/s] */
+#define C_ENDSTOP_RISE 100		/* current rise over C_ENDSTOP_RISE_MS that confirms twice as fast [mA] */
+#define C_ENDSTOP_RISE_MS 4u	/* power of 2 */
+
+/* PID position loop, 1ms, gains [Q8]: duty per 0.1deg, per 0.1deg*ms and per 0.1deg/s */
+#define C_PID_KP 20480u
+#define C_PID_KI 3u
+#define C_PID_KD 160u
+/* S-curve trajectory, 1ms: trapezoidal speed profile averaged over the jerk time */
+#define C_TRAJ_VMAX 800		   /* cruise speed [0.1deg/s], close to what 9V reaches at -40C */
+#define C_TRAJ_ACC 8		   /* acceleration [0.1deg/s per ms] */
+#define C_TRAJ_JERK_SHIFT 5u   /* jerk time 2^5 = 32ms */
+#define C_TRAJ_JERK_MS (1u << C_TRAJ_JERK_SHIFT)
+#define C_TRAJ_KPOS 10		   /* position loop gain [1/s] */
+#define C_TRAJ_KV 192		   /* velocity loop gain [Q8], duty per 0.1deg/s */
+#define C_TRAJ_KI 4			   /* velocity loop integral gain [Q8], duty per 0.1deg/s*ms */
+#define C_TRAJ_HOLD_ERROR 2000 /* following error that holds the profile while the output saturates [0.1deg/1000] */
+/* learned brake distance of the duty ramp, per direction, supply voltage and temperature band */
+#define C_BRAKE_VBINS 3u		/* below C_BRAKE_V_LOW, up to C_BRAKE_V_HIGH, above */
+#define C_BRAKE_TBINS 2u		/* below C_BRAKE_T_COLD, above */
+#define C_BRAKE_BINS (2u * C_BRAKE_VBINS * C_BRAKE_TBINS)
+#define C_BRAKE_V_LOW 1100u		/* [10mV] */
+#define C_BRAKE_V_HIGH 1350u	/* [10mV] */
+#define C_BRAKE_T_COLD 20		/* [C] */
+#define C_BRAKE_SLOW_MS 2u		/* speed below sensor.thd that ends the braking [ms] */
+#define C_BRAKE_TIMEOUT 500u	/* measurement abandoned after [ms] */
+#define C_BRAKE_MARGIN 10		/* creep distance left to the target [0.1deg] */
+#define C_BRAKE_MIN 10			/* [0.1deg] */
+#define C_BRAKE_MAX 75			/* [0.1deg], largest distance of the EEPROM nibble */
+#define C_BRAKE_NV_UNIT 5		/* EEPROM nibble [0.1deg] */
+#define C_BRAKE_DEFAULT (4 * C_GMR_ANGLE_SCALE_FACTOR) /* soft-stop threshold of an operating point not learned [0.1deg] */
+/* learned breakaway duty of the duty ramp, per temperature band */
+#define C_BREAKAWAY_TBINS 6u		/* C_BREAKAWAY_T_STEP wide from C_BREAKAWAY_T_MIN on */
+#define C_BREAKAWAY_T_MIN (-40)		/* [C] */
+#define C_BREAKAWAY_T_STEP 25		/* [C] */
+#define C_BREAKAWAY_I_MIN 100u		/* current from which the back-EMF model follows the duty [mA] */
+#define C_BREAKAWAY_EMF 30			/* back-EMF model speed above its standstill floor that detects the motion [0.1deg/s] */
+#define C_BREAKAWAY_LAG 3u		/* ramp steps the detection follows the breakaway, current filter and rotor acceleration */
+#define C_BREAKAWAY_MARGIN 3u		/* ramp steps the start stays below the learned duty */
+#define C_BREAKAWAY_MAX (C_PWMOUT_MAX_DUTY / 2u)	/* largest learned duty at C_MOT_VREF */
+#define C_BREAKAWAY_NV_UNIT 8u		/* EEPROM byte [duty] */
+/* gearbox play: moves end travelling towards C_BACKLASH_APPROACH_DIR, the play is measured on the calibration sweeps */
+#define C_BACKLASH_APPROACH_DIR 1		/* sign of the final travel of a move */
+#define C_BACKLASH_DEFAULT (1 * C_GMR_ANGLE_SCALE_FACTOR)	/* play until measured [0.1deg] */
+#define C_BACKLASH_MAX (5 * C_GMR_ANGLE_SCALE_FACTOR)		/* largest plausible play [0.1deg] */
+#define C_BACKLASH_MARGIN (1 * C_GMR_ANGLE_SCALE_FACTOR)	/* valve travel past the target before the approach [0.1deg] */
+#define C_BACKLASH_IGNORE (C_MOT_FINE_DEADBAND)	/* largest play without an approach [0.1deg] */
+#define C_BACKLASH_TRAVEL (3 * C_GMR_ANGLE_SCALE_FACTOR)	/* valve travel of the measurement [0.1deg] */
+#define C_BACKLASH_ONSET (1 * C_GMR_ANGLE_SCALE_FACTOR)	/* valve travel that ends the play, clear of the sensor noise [0.1deg] */
+#define C_BACKLASH_I_NOISE 20u		/* current rise that is no load change [mA] */
+#define C_BACKLASH_SPEED_MIN 300	/* model speed at the end of a measurement, below it I*R is most of the model [0.1deg/s] */
+/* predictive cut-off: the output stops early when the coast under the stop brake ends in the target window */
+#define C_COAST_TAU_DEFAULT 4	/* coast per speed, time constant of the braked rotor [1/1024 s] */
+#define C_COAST_TAU_MAX 64		/* [1/1024 s] */
+#define C_COAST_SPEED_MIN 200	/* slower rotors stop at the hysteresis [0.1deg/s] */
+#define C_COAST_SLOW_MS 2u		/* speed below sensor.thd that ends the coast [ms] */
+#define C_COAST_TIMEOUT 200u	/* measurement abandoned after [ms] */
+/* reversal of the duty ramp: short brake until the rotor stands, then start the other way */
+#define C_MOT_REVERSE_SPEED 100		/* speed of a standing rotor [0.1deg/s] */
+#define C_MOT_REVERSE_MS 2u			/* time below C_MOT_REVERSE_SPEED [ms] */
+#define C_MOT_REVERSE_TIMEOUT 100u	/* longest brake [ms] */
+/* active brake of the duty ramp in DEC: the rotor is braked down to the approach speed */
+#define C_MOT_BRAKE_KV 10			/* approach speed per remaining travel [0.1deg/s per 0.1deg], above the creep speed */
+#define C_MOT_BRAKE_KS 4			/* brake strength per excess speed [duty per 0.1deg/s] */
+#define C_MOT_STOP_BRAKE C_PWMOUT_MAX_DUTY	/* brake strength during the first second of a stop */
+/* fine positioning: duty pulses for a rotor that stopped, or coasted, off the target */
+#define C_MOT_FINE_RANGE (1.5f * C_GMR_ANGLE_SCALE_FACTOR)	/* largest error corrected with pulses [0.1deg] */
+#define C_MOT_FINE_DEADBAND (0.5f * C_GMR_ANGLE_SCALE_FACTOR)	/* smallest error corrected, clear of the sensor noise at the hysteresis [0.1deg] */
+#define C_MOT_FINE_SETTLE_MS 10u	/* rotor standing before a pulse [ms] */
+#define C_MOT_FINE_PULSE_MS 4u		/* shortest pulse [ms] */
+#define C_MOT_FINE_PULSE_MAX 100u	/* longest pulse, the gearbox play has to be taken up first [ms] */
+#define C_MOT_FINE_PULSES 6u		/* pulses per correction */
+#define C_MOT_FINE_GAIN 20			/* pulse duty per error [duty per 0.1deg] */
+#define C_MOT_FINE_STEP 150			/* trim of the pulse duty per pulse within a correction [duty] */
+#define C_MOT_FINE_MOVED 2			/* travel towards the target that ends a pulse, clear of the sensor noise [0.1deg] */
+
 typedef enum
 {
     MOTION_INIT,
@@ -54,19 +151,43 @@ typedef enum
     MOTION_ACC,
     MOTION_RUNNING,
     MOTION_DEC,
+    MOTION_FINE,
     MOTION_PAUSE,
     MOTION_STALL,
     MOTION_FAULT
 } tMotState;
+
+/* last coast after a cut-off, see MotGetCoastLog() */
+typedef struct
+{
+    int16_t speed;      /* speed at the cut-off [0.1deg/s] */
+    int16_t predicted;  /* coast of the model [0.1deg] */
+    int16_t coast;      /* travel until the rotor stood [0.1deg] */
+    int16_t restError;  /* target minus resting angle [0.1deg], signed like the travel */
+    int16_t tau;        /* model time constant after this coast [1/1024 s] */
+    uint16_t count;     /* coasts logged since reset */
+} tMotCoastLog;
+
 void MotRequestHardStop(void);
 void MotClearHardStop(void);
 void MotSetTargetPosition(int16_t targetPos);
 void MotSetCurrentPosition(int16_t currentPos);
 int16_t MotGetTargetPosition(void);
 int16_t MotGetCurrentPosition(void);
+int32_t MotGetContinuousTarget(void);
+int32_t MotGetContinuousPosition(void);
+int16_t MotGetSpeed(void);
 void MotSetParam(int16_t sensorThd, int16_t stallThd);
 void MotSetSoftStartAcc(uint16_t acc);
 void MotSetMaxDuty(uint16_t duty);
+void MotSetEndStopConfirm(uint16_t confirmTime);
+void MotSetCtrlMode(uint8_t mode);
+uint8_t MotGetCtrlMode(void);
+void MotSetPidGains(uint16_t kp, uint16_t ki, uint16_t kd);
+void MotSetBacklash(int16_t play);
+int16_t MotGetBacklash(void);
+void MotMeasureBacklash(void);
+const tMotCoastLog *MotGetCoastLog(void);
 tMotState MotGetState(void);
 uint8_t MotGetStallState(void);
 uint8_t MotGetFaultState(void);
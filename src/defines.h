@@ -56,9 +56,16 @@ pwm_Off() 
 #define POINT_TEST_ENABLE 0
 #define SOFTSTART_TEST_ENABLE 0
 #define DUTY_ADJUST_ENABLE 0
+#define BACKLASH_APPROACH_ENABLE 1 /* set to 0 to end moves travelling either way, see MotSetTargetPosition() */
+#define POSITION_HOLD_ENABLE 1 /* set to 0 to leave a drifting valve alone in standby, see ValveHoldWatchdog() */
+#define QUICK_CALIBRATION_ENABLE 1 /* set to 0 to derive only the touched end on a quick calibration, see ValveQuickCalCheck() */
+#define GMR_FIT_ENABLE 1 /* set to 0 to keep the GMR bridge correction of the calibration record, see gmr_fit_Update() */
+#define GMR_HARMONIC_ENABLE 1 /* set to 0 to leave the 4th harmonic angle error of the GMR in, see gmr_harm_Update() */
+#define GMR_PLAUSIBILITY_ENABLE 1 /* set to 0 to detect a GMR fault by the stalled motor only, see gmr_plausibility_check() */
 #define LIN_WAKEUP_DISABLE 1
 #define VALVE_IGN_PIN 0
 #define DEBUG_GPIO_ENABLE 0 /* set to 1 to enable GPIO debug */
+#define PROFILER_ENABLE 0	/* set to 1 to profile the task execution times, see profiler.h */
 #define DEBUG_PIN 7
 #define DEBUG_INTERRUT_TIMER 0
 #define DEBUG_MAIN_TASK_DURATION 1
@@ -74,6 +81,11 @@ pwm_Off() 
 
 #define C_PWMOUT_MAX_DUTY 2048U
 
+#define C_MOT_CTRL_RAMP 1u	 /* duty ramp state machine ACC -> RUNNING -> DEC */
+#define C_MOT_CTRL_PID 2u	 /* PID position loop */
+#define C_MOT_CTRL_SCURVE 3u /* S-curve trajectory with velocity loop */
+#define C_MOT_CTRL_MODE C_MOT_CTRL_RAMP /* build default motor controller, EEPROM page 3 overrides */
+
 #define C_VOLTAGE_RESOLUTION_SCALE 100u
 #define C_CURRENT_RESOLUTION_SCALE 1000u
 #define C_TEMP_RESOLUTION_SCALE 1u
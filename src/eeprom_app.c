@@ -44,6 +44,51 @@ const user_pattern_t eeprom_defaults =
                 .payload = {0},
             },
         .page[2] =
+            {
+                .crc8 = 0xFF,
+                .payload = {0},
+            },
+        .page[3] =
+            {
+                .crc8 = 0xFF,
+                .payload = {0},
+            },
+        .page[4] =
+            {
+                .crc8 = 0xFF,
+                .payload = {0},
+            },
+        .page[5] =
+            {
+                .crc8 = 0xFF,
+                .payload = {0},
+            },
+        .page[6] =
+            {
+                .crc8 = 0xFF,
+                .payload = {0},
+            },
+        .page[7] =
+            {
+                .crc8 = 0xFF,
+                .payload = {0},
+            },
+        .page[8] =
+            {
+                .crc8 = 0xFF,
+                .payload = {0},
+            },
+        .page[9] =
+            {
+                .crc8 = 0xFF,
+                .payload = {0},
+            },
+        .page[10] =
+            {
+                .crc8 = 0xFF,
+                .payload = {0},
+            },
+        .page[11] =
             {
                 .crc8 = 0xFF,
                 .payload = {0},
@@ -51,6 +96,15 @@ const user_pattern_t eeprom_defaults =
 
 valve_config_t valve_gmr_data;
 valve_config_t valve_diag_data;
+/* ---------------------------------------------
+ * Local Defines
+ * --------------------------------------------- */
+
+/** number of bytes of the calibration record */
+#define C_CAL_NV_SIZE (C_CAL_NV_PAGES * 7u)
+/** number of 16 bit fields of the calibration record, after version, generation and CRC-8 */
+#define C_CAL_NV_FIELDS 12u
+
 /* ---------------------------------------------
  * Local Variables
  * --------------------------------------------- */
@@ -59,6 +113,8 @@ valve_config_t valve_diag_data;
  * Local Function Declarations
  * --------------------------------------------- */
 
+static uint8_t eeprom_CalCrc8(const uint8_t *bytes);
+
 /**
  * Module initialization
  */
@@ -70,7 +126,14 @@ bool eeprom_Init(void)
 
     if (!unirom_LoadUserConfig())
     {
-        (void)unirom_ResetUserConfig(&eeprom_defaults);
+        user_pattern_t config = eeprom_defaults;
+
+        /* keep the valid pages, e.g. the GMR calibration when the pattern got a page more */
+        for (uint8_t page = 0u; page < sizeof(user_pattern_t) / sizeof(page_t); page++)
+        {
+            (void)unirom_ReadPage(page, &config.page[page].payload[0], sizeof(config.page[page].payload));
+        }
+        (void)unirom_ResetUserConfig(&config);
 
         retval = false;
     }
@@ -197,6 +260,328 @@ bool eeprom_WriteDiagConfig(valve_config_t *config)
     (void)unirom_WritePage(2u, &bytes[0], sizeof(valve_config_t));
     return retval;
 }
+
+/** Read motor controller configuration
+ *
+ * @param[out]  config  the controller mode and gains
+ * @retval  true  valid configuration found in eeprom.
+ * @retval  false  otherwise.
+ */
+bool eeprom_ReadCtrlConfig(mot_ctrl_config_t *config)
+{
+    bool retval = false;
+    uint8_t bytes[7];
+
+    if (unirom_ReadPage(3u, &bytes[0], sizeof(bytes)))
+    {
+        config->mode = bytes[0];
+        config->kp = (uint16_t)(bytes[1] + ((uint16_t)bytes[2] << 8));
+        config->ki = (uint16_t)(bytes[3] + ((uint16_t)bytes[4] << 8));
+        config->kd = (uint16_t)(bytes[5] + ((uint16_t)bytes[6] << 8));
+        retval = true;
+    }
+
+    return retval;
+}
+
+/** Store motor controller configuration
+ *
+ * @param[in]  config  the controller mode and gains
+ * @retval  true  the configuration is correctly stored
+ */
+bool eeprom_WriteCtrlConfig(mot_ctrl_config_t *config)
+{
+    uint8_t bytes[7];
+
+    bytes[0] = config->mode;
+    bytes[1] = (uint8_t)(config->kp & 0xFF);
+    bytes[2] = (uint8_t)((config->kp >> 8) & 0xFF);
+    bytes[3] = (uint8_t)(config->ki & 0xFF);
+    bytes[4] = (uint8_t)((config->ki >> 8) & 0xFF);
+    bytes[5] = (uint8_t)(config->kd & 0xFF);
+    bytes[6] = (uint8_t)((config->kd >> 8) & 0xFF);
+
+    (void)unirom_WritePage(3u, &bytes[0], sizeof(bytes));
+    (void)unirom_StorePage(3u);
+    return true;
+}
+
+/** Read the motor model
+ *
+ * @param[out]  config  winding resistance, its temperature coefficient and back-EMF constant
+ * @retval  true  valid page found in eeprom.
+ * @retval  false  otherwise.
+ */
+bool eeprom_ReadMotorModel(mot_model_config_t *config)
+{
+    bool retval = false;
+    uint8_t bytes[6];
+
+    if (unirom_ReadPage(C_MOT_MODEL_NV_PAGE, &bytes[0], sizeof(bytes)))
+    {
+        config->r25 = (uint16_t)(bytes[0] + ((uint16_t)bytes[1] << 8));
+        config->rTc = (uint16_t)(bytes[2] + ((uint16_t)bytes[3] << 8));
+        config->ke = (uint16_t)(bytes[4] + ((uint16_t)bytes[5] << 8));
+        retval = true;
+    }
+
+    return retval;
+}
+
+/** Store the motor model
+ *
+ * @param[in]  config  winding resistance, its temperature coefficient and back-EMF constant
+ * @retval  true  the model is correctly stored
+ */
+bool eeprom_WriteMotorModel(mot_model_config_t *config)
+{
+    uint8_t bytes[6];
+
+    bytes[0] = (uint8_t)(config->r25 & 0xFF);
+    bytes[1] = (uint8_t)((config->r25 >> 8) & 0xFF);
+    bytes[2] = (uint8_t)(config->rTc & 0xFF);
+    bytes[3] = (uint8_t)((config->rTc >> 8) & 0xFF);
+    bytes[4] = (uint8_t)(config->ke & 0xFF);
+    bytes[5] = (uint8_t)((config->ke >> 8) & 0xFF);
+
+    (void)unirom_WritePage(C_MOT_MODEL_NV_PAGE, &bytes[0], sizeof(bytes));
+    (void)unirom_StorePage(C_MOT_MODEL_NV_PAGE);
+    return true;
+}
+
+/** Read the learned brake distances
+ *
+ * @param[out]  table  the brake distance per operating point
+ * @retval  true  a table of the current layout found in eeprom.
+ * @retval  false  otherwise.
+ */
+bool eeprom_ReadBrakeTable(mot_brake_table_t *table)
+{
+    bool retval = false;
+    uint8_t bytes[7];
+
+    if (unirom_ReadPage(4u, &bytes[0], sizeof(bytes)) && (bytes[6] == C_BRAKE_NV_LAYOUT))
+    {
+        for (uint8_t i = 0u; i < C_BRAKE_NV_ENTRIES; i++)
+        {
+            table->dist[i] = (uint8_t)((bytes[i >> 1] >> ((i & 1u) * 4u)) & 0x0Fu);
+        }
+        retval = true;
+    }
+
+    return retval;
+}
+
+/** Store the learned brake distances
+ *
+ * @param[in]  table  the brake distance per operating point, values above 15 are limited
+ * @retval  true  the table is correctly stored
+ */
+bool eeprom_WriteBrakeTable(mot_brake_table_t *table)
+{
+    uint8_t bytes[7] = {0};
+
+    for (uint8_t i = 0u; i < C_BRAKE_NV_ENTRIES; i++)
+    {
+        uint8_t dist = (table->dist[i] > 0x0Fu) ? 0x0Fu : table->dist[i];
+
+        bytes[i >> 1] |= (uint8_t)(dist << ((i & 1u) * 4u));
+    }
+    bytes[6] = C_BRAKE_NV_LAYOUT;
+
+    (void)unirom_WritePage(4u, &bytes[0], sizeof(bytes));
+    (void)unirom_StorePage(4u);
+    return true;
+}
+/** Read the learned breakaway duties
+ *
+ * @param[out]  table  the breakaway duty per temperature band
+ * @retval  true  a table of the current layout found in eeprom.
+ * @retval  false  otherwise.
+ */
+bool eeprom_ReadBreakawayTable(mot_breakaway_table_t *table)
+{
+    bool retval = false;
+    uint8_t bytes[7];
+
+    if (unirom_ReadPage(5u, &bytes[0], sizeof(bytes)) && (bytes[6] == C_BREAKAWAY_NV_LAYOUT))
+    {
+        for (uint8_t i = 0u; i < C_BREAKAWAY_NV_ENTRIES; i++)
+        {
+            table->duty[i] = bytes[i];
+        }
+        retval = true;
+    }
+
+    return retval;
+}
+
+/** Store the learned breakaway duties
+ *
+ * @param[in]  table  the breakaway duty per temperature band
+ * @retval  true  the table is correctly stored
+ */
+bool eeprom_WriteBreakawayTable(mot_breakaway_table_t *table)
+{
+    uint8_t bytes[7] = {0};
+
+    for (uint8_t i = 0u; i < C_BREAKAWAY_NV_ENTRIES; i++)
+    {
+        bytes[i] = table->duty[i];
+    }
+    bytes[6] = C_BREAKAWAY_NV_LAYOUT;
+
+    (void)unirom_WritePage(5u, &bytes[0], sizeof(bytes));
+    (void)unirom_StorePage(5u);
+    return true;
+}
+
+/** Read the gearbox play measured by the calibration
+ *
+ * @param[out]  play  the gearbox play [0.1deg]
+ * @retval  true  a play of the current layout found in eeprom.
+ * @retval  false  otherwise.
+ */
+bool eeprom_ReadBacklash(int16_t *play)
+{
+    bool retval = false;
+    uint8_t bytes[7];
+
+    if (unirom_ReadPage(6u, &bytes[0], sizeof(bytes)) && (bytes[6] == C_BACKLASH_NV_LAYOUT))
+    {
+        *play = (int16_t)bytes[0];
+        retval = true;
+    }
+
+    return retval;
+}
+
+/** Read the end stop travel measured by the last full calibration
+ *
+ * @param[out]  travel  Mode A minus Mode B angle [0.1deg]
+ * @retval  true  a travel of the current layout found in eeprom.
+ * @retval  false  otherwise.
+ */
+bool eeprom_ReadTravel(int16_t *travel)
+{
+    bool retval = false;
+    uint8_t bytes[7];
+
+    if (unirom_ReadPage(6u, &bytes[0], sizeof(bytes)) && (bytes[6] == C_BACKLASH_NV_LAYOUT))
+    {
+        *travel = (int16_t)((uint16_t)bytes[1] | ((uint16_t)bytes[2] << 8));
+        retval = (*travel != 0);
+    }
+
+    return retval;
+}
+
+/** Read the calibration record
+ *
+ * The record is accepted when all its pages are valid, the schema is C_CAL_NV_VERSION and
+ * the CRC-8 over the whole record matches.
+ * @param[out]  record  the stored calibration
+ * @retval  true  a consistent record of the current schema found in eeprom.
+ * @retval  false  otherwise.
+ */
+bool eeprom_ReadCalRecord(valve_cal_record_t *record)
+{
+    bool retval = true;
+    uint8_t bytes[C_CAL_NV_SIZE];
+    int16_t fields[C_CAL_NV_FIELDS];
+
+    for (uint8_t page = 0u; page < C_CAL_NV_PAGES; page++)
+    {
+        if (unirom_ReadPage(C_CAL_NV_PAGE + page, &bytes[page * 7u], 7u) == false)
+        {
+            retval = false;
+        }
+    }
+    if (retval && (bytes[0] == C_CAL_NV_VERSION) && (bytes[2] == eeprom_CalCrc8(&bytes[0])))
+    {
+        for (uint8_t i = 0u; i < C_CAL_NV_FIELDS; i++)
+        {
+            fields[i] = (int16_t)((uint16_t)bytes[3u + (2u * i)] | ((uint16_t)bytes[4u + (2u * i)] << 8));
+        }
+        record->generation = bytes[1];
+        record->gmrOffset = fields[0];
+        record->d0Angle = fields[1];
+        record->d360Angle = fields[2];
+        record->travel = fields[3];
+        record->backlash = fields[4];
+        record->sinOffset = fields[5];
+        record->cosOffset = fields[6];
+        record->sinAmplitude = fields[7];
+        record->cosAmplitude = fields[8];
+        record->quadrature = fields[9];
+        record->harmCos = fields[10];
+        record->harmSin = fields[11];
+    }
+    else
+    {
+        retval = false;
+    }
+
+    return retval;
+}
+
+/** Store the calibration record
+ *
+ * Only the pages whose content changed are written.
+ * @param[in]  record  the calibration to store
+ * @retval  true  the record is correctly stored
+ */
+bool eeprom_WriteCalRecord(const valve_cal_record_t *record)
+{
+    uint8_t bytes[C_CAL_NV_SIZE];
+    const int16_t fields[C_CAL_NV_FIELDS] = {
+        record->gmrOffset, record->d0Angle, record->d360Angle, record->travel, record->backlash,
+        record->sinOffset, record->cosOffset, record->sinAmplitude, record->cosAmplitude,
+        record->quadrature, record->harmCos, record->harmSin};
+
+    for (uint8_t i = (uint8_t)(3u + (2u * C_CAL_NV_FIELDS)); i < C_CAL_NV_SIZE; i++)
+    {
+        bytes[i] = 0u; /* unused tail of the last page */
+    }
+    bytes[0] = C_CAL_NV_VERSION;
+    bytes[1] = record->generation;
+    for (uint8_t i = 0u; i < C_CAL_NV_FIELDS; i++)
+    {
+        bytes[3u + (2u * i)] = (uint8_t)((uint16_t)fields[i] & 0xFFu);
+        bytes[4u + (2u * i)] = (uint8_t)((uint16_t)fields[i] >> 8);
+    }
+    bytes[2] = eeprom_CalCrc8(&bytes[0]);
+
+    for (uint8_t page = 0u; page < C_CAL_NV_PAGES; page++)
+    {
+        (void)unirom_WritePage(C_CAL_NV_PAGE + page, &bytes[page * 7u], 7u);
+        (void)unirom_StorePage(C_CAL_NV_PAGE + page);
+    }
+    return true;
+}
+
+/** CRC-8 of the calibration record
+ *
+ * Polynomial 0x07, initial value 0xFF, the CRC byte itself counts as 0.
+ * @param[in]  bytes  the C_CAL_NV_SIZE bytes of the record
+ * @return  the CRC-8
+ */
+static uint8_t eeprom_CalCrc8(const uint8_t *bytes)
+{
+    uint8_t crc = 0xFFu;
+
+    for (uint8_t i = 0u; i < C_CAL_NV_SIZE; i++)
+    {
+        crc ^= (i == 2u) ? 0u : bytes[i];
+        for (uint8_t bit = 0u; bit < 8u; bit++)
+        {
+            crc = ((crc & 0x80u) != 0u) ? (uint8_t)((uint8_t)(crc << 1) ^ 0x07u) : (uint8_t)(crc << 1);
+        }
+    }
+
+    return crc;
+}
+
 void eeprom_StoreUserDataConfig(uint16_t index)
 {
     if (index == 1)
@@ -37,6 +37,80 @@ typedef struct valve_config
 } valve_config_t;
 extern valve_config_t valve_diag_data;
 extern valve_config_t valve_gmr_data;
+
+/** motor controller configuration, page 3 */
+typedef struct mot_ctrl_config
+{
+    uint8_t mode; /**< 0: build default, else C_MOT_CTRL_RAMP, C_MOT_CTRL_PID or C_MOT_CTRL_SCURVE */
+    uint16_t kp;  /**< PID gains, kp = 0: build default gains */
+    uint16_t ki;
+    uint16_t kd;
+} mot_ctrl_config_t;
+
+/** page of the motor model */
+#define C_MOT_MODEL_NV_PAGE 11u
+
+/** motor model of the back-EMF speed estimate, page 11, a field of 0 or 0xFFFF keeps the
+ *  build default (C_MOT_R25, C_MOT_R_TC, C_MOT_KE) */
+typedef struct mot_model_config
+{
+    uint16_t r25; /**< winding resistance at 25C [mOhm] */
+    uint16_t rTc; /**< winding resistance temperature coefficient [1/K, Q16] */
+    uint16_t ke;  /**< back-EMF constant at the valve shaft [mV per deg/s] */
+} mot_model_config_t;
+
+/** number of learned brake distances, 4 bit each */
+#define C_BRAKE_NV_ENTRIES 12u
+/** layout of page 4, a table of another layout is ignored */
+#define C_BRAKE_NV_LAYOUT 0x01u
+
+/** learned brake distances of the duty ramp, page 4 */
+typedef struct mot_brake_table
+{
+    uint8_t dist[C_BRAKE_NV_ENTRIES]; /**< brake distance [0.5deg], 0: not learned */
+} mot_brake_table_t;
+
+/** number of learned breakaway duties, 1 byte each */
+#define C_BREAKAWAY_NV_ENTRIES 6u
+/** layout of page 5, a table of another layout is ignored */
+#define C_BREAKAWAY_NV_LAYOUT 0x01u
+
+/** learned breakaway duties of the duty ramp, page 5 */
+typedef struct mot_breakaway_table
+{
+    uint8_t duty[C_BREAKAWAY_NV_ENTRIES]; /**< breakaway duty at C_MOT_VREF [8 duty], 0: not learned */
+} mot_breakaway_table_t;
+
+/** layout of page 6, the gearbox play [0.1deg] in byte 0 and the end stop travel [0.1deg] in
+ *  bytes 1~2 (0: not measured), a page of another layout is ignored. Read only, the
+ *  calibration record replaces it. */
+#define C_BACKLASH_NV_LAYOUT 0x01u
+
+/** first page of the calibration record */
+#define C_CAL_NV_PAGE 7u
+/** number of pages of the calibration record */
+#define C_CAL_NV_PAGES 4u
+/** schema of the calibration record, a record of another schema is ignored */
+#define C_CAL_NV_VERSION 0x03u
+
+/** calibration record, pages 7~10: schema version, generation and a CRC-8 over the whole
+ *  record precede the fields, so that pages of different records are never combined */
+typedef struct valve_cal_record
+{
+    uint8_t generation;   /**< counts the stored records */
+    int16_t gmrOffset;    /**< GMR sensor offset [0.1deg] */
+    int16_t d0Angle;      /**< Mode B angle, 0d end stop side [0.1deg] */
+    int16_t d360Angle;    /**< Mode A angle, 360d end stop side [0.1deg] */
+    int16_t travel;       /**< Mode A minus Mode B of the last full calibration [0.1deg], 0: none */
+    int16_t backlash;     /**< gearbox play [0.1deg], -1: not measured */
+    int16_t sinOffset;    /**< GMR sine output offset [LSB] */
+    int16_t cosOffset;    /**< GMR cosine output offset [LSB] */
+    int16_t sinAmplitude; /**< GMR sine output amplitude [LSB], 0: not measured */
+    int16_t cosAmplitude; /**< GMR cosine output amplitude [LSB], 0: not measured */
+    int16_t quadrature;   /**< GMR cosine output phase error, sin(phase) [Q15] */
+    int16_t harmCos;      /**< GMR 4th harmonic angle error, cos(4 sensor angle) part [0.01deg] */
+    int16_t harmSin;      /**< GMR 4th harmonic angle error, sin(4 sensor angle) part [0.01deg] */
+} valve_cal_record_t;
 /* ---------------------------------------------
  * Public Function Declarations
  * --------------------------------------------- */
@@ -48,6 +122,18 @@ bool eeprom_ReadValveConfig(valve_config_t *config);
 bool eeprom_WriteValveConfig(valve_config_t *config);
 bool eeprom_ReadDiagConfig(valve_config_t *config);
 bool eeprom_WriteDiagConfig(valve_config_t *config);
+bool eeprom_ReadCtrlConfig(mot_ctrl_config_t *config);
+bool eeprom_WriteCtrlConfig(mot_ctrl_config_t *config);
+bool eeprom_ReadMotorModel(mot_model_config_t *config);
+bool eeprom_WriteMotorModel(mot_model_config_t *config);
+bool eeprom_ReadBrakeTable(mot_brake_table_t *table);
+bool eeprom_WriteBrakeTable(mot_brake_table_t *table);
+bool eeprom_ReadBreakawayTable(mot_breakaway_table_t *table);
+bool eeprom_WriteBreakawayTable(mot_breakaway_table_t *table);
+bool eeprom_ReadBacklash(int16_t *play);
+bool eeprom_ReadTravel(int16_t *travel);
+bool eeprom_ReadCalRecord(valve_cal_record_t *record);
+bool eeprom_WriteCalRecord(const valve_cal_record_t *record);
 void eeprom_StoreUserDataConfig(uint16_t index);
 void valve_gmr_write(uint16_t data1, uint16_t data2, uint16_t data3);
 void valve_diag_write(uint16_t data1, uint16_t data2, uint16_t data3);
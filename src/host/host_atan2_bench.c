@@ -0,0 +1,303 @@
+/**
+ * @file
+ * @brief Host build atan2 kernel benchmark
+ * @internal
+ *
+ * @copyright (C) 2025 Melexis N.V.
+ *
+ * Melexis N.V. is supplying this code for use with Melexis N.V. processor based microcontrollers only.
+ *
+ * THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED OR STATUTORY,
+ * INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.  MELEXIS N.V. SHALL NOT IN ANY CIRCUMSTANCES,
+ * BE LIABLE FOR SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON WHATSOEVER.
+ *
+ * @endinternal
+ *
+ * @ingroup host
+ *
+ * @details Compares the atan2 kernels selectable for calculate_gmr_angle() (GMR_ATAN2_KERNEL
+ *          in app_sensor.c). Every kernel gets the sin/cos outputs of a GMR bridge of a given
+ *          amplitude on a fine angle grid, rounded to integers as the adc delivers them, and
+ *          is compared with the double precision atan2 of the same integers. The errors are
+ *          reported in 0.1 deg, the unit of the application angles.
+ *
+ *          The cost of a kernel is given as:
+ *          - path: executed MLX16 instructions for a first octant angle, counted from the
+ *            target listing (libmath) or the assembly in fm_atan2.h (fast math), call
+ *            included; divu is a multi-cycle instruction and is counted once;
+ *          - code: code size in bytes from the map file (libmath) or the symbol table of
+ *            libfast_math.a, without the 516 byte LUT;
+ *          - lss: instructions of the kernel functions found in the listing given with -l,
+ *            '-' when the kernel is not linked into that image.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <math.h>
+#include <mathlib.h>
+#include <fm_atan2.h>
+
+/* ---------------------------------------------
+ * Local Defines
+ * --------------------------------------------- */
+
+/** default target listing, relative to src/host */
+#define C_BENCH_LSS_FILE        "../81332-xLW-BMx-202_Woory_4Way_Valve.lss"
+/** maximum number of listing functions of a kernel */
+#define C_BENCH_MAX_SYMBOLS     3u
+/** 0.1 deg per atan2 LSB (2pi/65536) */
+#define C_BENCH_LSB_TO_DDEG     (3600.0 / 65536.0)
+
+/* ---------------------------------------------
+ * Local Types
+ * --------------------------------------------- */
+
+/** atan2 kernel under test */
+typedef struct
+{
+    const char * pName;                             /**< function name */
+    int16_t (*fKernel)(int16_t y, int16_t x);       /**< kernel */
+    uint16_t u16PathInstr;                          /**< executed instructions, first octant */
+    uint16_t u16CodeSize;                           /**< code size [bytes] */
+    const char * apSymbols[C_BENCH_MAX_SYMBOLS];    /**< listing functions of the kernel */
+} BenchKernel_t;
+
+/** error statistics [0.1 deg] */
+typedef struct
+{
+    double dMax;
+    double dSum;
+    double dSumSq;
+    uint32_t u32Count;
+} BenchError_t;
+
+/* ---------------------------------------------
+ * Local Function Prototypes
+ * --------------------------------------------- */
+
+static int16_t bench_p_atan2I16(int16_t y, int16_t x);
+
+/* ---------------------------------------------
+ * Local Variables
+ * --------------------------------------------- */
+
+static const BenchKernel_t l_asKernel[] =
+{
+    {"atan2I16",                          atan2I16,                          41u, 138u, {"_atan2I16", "_atan2_lookup", "_atan2_helper"}},
+    {"p_atan2I16",                        bench_p_atan2I16,                  19u, 338u, {"_p_atan2I16", NULL, NULL}},
+    {"fm_Atan2I16DirectLutInlined",       fm_Atan2I16DirectLutInlined,       19u, 338u, {"_p_atan2I16", NULL, NULL}},
+    {"fm_Atan2I16DirectLutNonInlined",    fm_Atan2I16DirectLutNonInlined,    20u, 348u, {"_fm_Atan2I16DirectLutNonInlined", "_p_atan2I16", NULL}},
+    {"fm_Atan2I16InterpolationInlined",   fm_Atan2I16InterpolationInlined,   26u, 604u, {NULL, NULL, NULL}},
+    {"fm_Atan2I16InterpolationNonInlined", fm_Atan2I16InterpolationNonInlined, 28u, 604u, {"_fm_Atan2I16InterpolationNonInlined", NULL, NULL}},
+};
+
+#define C_BENCH_NR_OF_KERNELS (sizeof(l_asKernel) / sizeof(l_asKernel[0]))
+
+static const int16_t l_ai16Amplitude[] = {128, 256, 512, 2048, 16384};
+
+/* ---------------------------------------------
+ * Local Functions
+ * --------------------------------------------- */
+
+/** p_atan2I16() takes the coordinates as unsigned */
+static int16_t bench_p_atan2I16(int16_t y, int16_t x)
+{
+    return p_atan2I16((uint16_t)y, (uint16_t)x);
+}
+
+/** Count the instructions of a function in an objdump listing
+ * @param[in]  pFile    listing
+ * @param[in]  pSymbol  function symbol, e.g. "_atan2I16"
+ * @return  number of instructions, -1 when the function is not in the listing
+ */
+static int32_t bench_LssCount(FILE * pFile, const char * pSymbol)
+{
+    char acLine[256];
+    char acHeader[128];
+    int32_t i32Count = -1;
+
+    (void)snprintf(acHeader, sizeof(acHeader), "<%s>:", pSymbol);
+    rewind(pFile);
+    while (fgets(acLine, sizeof(acLine), pFile) != NULL)
+    {
+        if (isxdigit((unsigned char)acLine[0]))
+        {
+            /* "0000a27a <_name>:" starts a function, local labels "<.Lxx>:" continue it */
+            char * pLabel = strchr(acLine, '<');
+
+            if (i32Count >= 0)
+            {
+                if ((pLabel != NULL) && (pLabel[1] != '.'))
+                {
+                    break;
+                }
+            }
+            else if (strstr(acLine, acHeader) != NULL)
+            {
+                i32Count = 0;
+            }
+        }
+        else if ((i32Count >= 0) && (acLine[0] == ' '))
+        {
+            /* "    a27a:\tac00      \tcmp\tA, #0" */
+            char * pColon = strchr(acLine, ':');
+
+            if ((pColon != NULL) && (pColon[1] == '\t'))
+            {
+                i32Count++;
+            }
+        }
+    }
+    return i32Count;
+}
+
+static void bench_ErrorAdd(BenchError_t * pError, double dError)
+{
+    if (fabs(dError) > pError->dMax)
+    {
+        pError->dMax = fabs(dError);
+    }
+    pError->dSum += dError;
+    pError->dSumSq += dError * dError;
+    pError->u32Count++;
+}
+
+/** Run a kernel on a GMR circle
+ * @param[in]   pKernel     kernel
+ * @param[in]   i16Amp      sin/cos amplitude [LSB]
+ * @param[in]   dStep       angle step [deg]
+ * @param[out]  pError      error statistics [0.1 deg]
+ */
+static void bench_Run(const BenchKernel_t * pKernel, int16_t i16Amp, double dStep, BenchError_t * pError)
+{
+    double dAngle;
+
+    memset(pError, 0, sizeof(*pError));
+    for (dAngle = 0.0; dAngle < 360.0; dAngle += dStep)
+    {
+        int16_t y = (int16_t)lround(i16Amp * sin(dAngle * (M_PI / 180.0)));
+        int16_t x = (int16_t)lround(i16Amp * cos(dAngle * (M_PI / 180.0)));
+        double dRef = atan2((double)y, (double)x) * (32768.0 / M_PI);
+        double dError = (double)pKernel->fKernel(y, x) - dRef;
+
+        /* compare on the circle */
+        while (dError > 32768.0)
+        {
+            dError -= 65536.0;
+        }
+        while (dError < -32768.0)
+        {
+            dError += 65536.0;
+        }
+        bench_ErrorAdd(pError, dError * C_BENCH_LSB_TO_DDEG);
+    }
+}
+
+static void bench_Usage(const char * pName)
+{
+    printf("Usage: %s [-a amplitude] [-s step] [-l listing]\n", pName);
+    printf("  -a amplitude  single GMR sin/cos amplitude [LSB] instead of the sweep\n");
+    printf("  -s step       angle grid step (default 0.01 deg)\n");
+    printf("  -l listing    target listing for the instruction counts (default %s)\n", C_BENCH_LSS_FILE);
+}
+
+/* ---------------------------------------------
+ * Public Functions Implementation
+ * --------------------------------------------- */
+
+int main(int argc, char * argv[])
+{
+    const char * pLssName = C_BENCH_LSS_FILE;
+    double dStep = 0.01;
+    int32_t i32Amp = 0;
+    FILE * pLss;
+    uint16_t i, k;
+
+    for (i = 1u; i < (uint16_t)argc; i++)
+    {
+        if ((strcmp(argv[i], "-a") == 0) && ((i + 1) < argc))
+        {
+            i32Amp = (int32_t)strtol(argv[++i], NULL, 0);
+        }
+        else if ((strcmp(argv[i], "-s") == 0) && ((i + 1) < argc))
+        {
+            dStep = strtod(argv[++i], NULL);
+        }
+        else if ((strcmp(argv[i], "-l") == 0) && ((i + 1) < argc))
+        {
+            pLssName = argv[++i];
+        }
+        else
+        {
+            bench_Usage(argv[0]);
+            return 1;
+        }
+    }
+    if ((i32Amp < 0) || (i32Amp > 32767) || (dStep <= 0.0))
+    {
+        bench_Usage(argv[0]);
+        return 1;
+    }
+
+    pLss = fopen(pLssName, "r");
+    printf("Cost (listing %s%s)\n", pLssName, (pLss == NULL) ? " not found" : "");
+    printf("  %-36s %5s %5s %5s\n", "kernel", "path", "code", "lss");
+    for (k = 0u; k < C_BENCH_NR_OF_KERNELS; k++)
+    {
+        const BenchKernel_t * pKernel = &l_asKernel[k];
+        int32_t i32Lss = -1;
+
+        for (i = 0u; (pLss != NULL) && (i < C_BENCH_MAX_SYMBOLS) && (pKernel->apSymbols[i] != NULL); i++)
+        {
+            int32_t i32Count = bench_LssCount(pLss, pKernel->apSymbols[i]);
+
+            if (i32Count < 0)
+            {
+                i32Lss = -1;
+                break;
+            }
+            i32Lss = ((i32Lss < 0) ? 0 : i32Lss) + i32Count;
+        }
+        if (i32Lss >= 0)
+        {
+            printf("  %-36s %5u %5u %5d\n", pKernel->pName, pKernel->u16PathInstr, pKernel->u16CodeSize, (int)i32Lss);
+        }
+        else
+        {
+            printf("  %-36s %5u %5u %5s\n", pKernel->pName, pKernel->u16PathInstr, pKernel->u16CodeSize, "-");
+        }
+    }
+    if (pLss != NULL)
+    {
+        (void)fclose(pLss);
+    }
+
+    printf("\nAccuracy (grid %.3f deg) [0.1 deg]\n", dStep);
+    printf("  %-36s %6s %7s %7s %7s\n", "kernel", "amp", "max", "rms", "mean");
+    for (i = 0u; i < (sizeof(l_ai16Amplitude) / sizeof(l_ai16Amplitude[0])); i++)
+    {
+        int16_t i16Amp = (i32Amp != 0) ? (int16_t)i32Amp : l_ai16Amplitude[i];
+
+        for (k = 0u; k < C_BENCH_NR_OF_KERNELS; k++)
+        {
+            BenchError_t sError;
+
+            bench_Run(&l_asKernel[k], i16Amp, dStep, &sError);
+            printf("  %-36s %6d %7.3f %7.3f %+7.3f\n", l_asKernel[k].pName, i16Amp, sError.dMax,
+                   sqrt(sError.dSumSq / sError.u32Count), sError.dSum / sError.u32Count);
+        }
+        if (i32Amp != 0)
+        {
+            break;
+        }
+        printf("\n");
+    }
+    return 0;
+}
+
+/* EOF */
@@ -0,0 +1,127 @@
+/**
+ * @file
+ * @brief Host build EEPROM model
+ * @internal
+ *
+ * @copyright (C) 2025 Melexis N.V.
+ *
+ * Melexis N.V. is supplying this code for use with Melexis N.V. processor based microcontrollers only.
+ *
+ * THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED OR STATUTORY,
+ * INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.  MELEXIS N.V. SHALL NOT IN ANY CIRCUMSTANCES,
+ * BE LIABLE FOR SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON WHATSOEVER.
+ *
+ * @endinternal
+ *
+ * @ingroup host
+ *
+ * @details The user EEPROM area used by the unirom library is a RAM image, erased (0x00) at
+ *          start-up unless host_eeprom_Load() restores a previous image. The Melexis
+ *          calibration cells (eeNNN) are instantiated here with zero trimming.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+#include <memory_map.h>
+
+/* instantiate the calibration cells the platform only declares */
+#define extern
+#include <eeprom_parameters.h>
+#undef extern
+
+#include <eeprom_drv.h>
+#include <mem_checks.h>
+#include "host_eeprom.h"
+
+/* ---------------------------------------------
+ * Public Variables
+ * --------------------------------------------- */
+
+/** EEPROM image, addressed from EEPROM_START */
+uint8_t g_au8HostEeprom[EEPROM_SIZE] __attribute__((aligned(2)));
+
+/** number of 64-bit EEPROM page writes since start-up */
+uint32_t g_u32HostEepromWrites = 0u;
+
+/* ---------------------------------------------
+ * Public Functions Implementation
+ * --------------------------------------------- */
+
+/** Erase the EEPROM image */
+void host_eeprom_Erase(void)
+{
+    (void)memset(g_au8HostEeprom, 0, sizeof(g_au8HostEeprom));
+    g_u32HostEepromWrites = 0u;
+}
+
+/** Restore the EEPROM image from a file
+ * @param[in]  pFileName  image file name
+ * @retval  true  image restored
+ */
+bool host_eeprom_Load(const char * pFileName)
+{
+    bool bRetVal = false;
+    FILE * pFile = fopen(pFileName, "rb");
+
+    if (pFile != NULL)
+    {
+        bRetVal = (fread(g_au8HostEeprom, 1u, sizeof(g_au8HostEeprom), pFile) == sizeof(g_au8HostEeprom));
+        (void)fclose(pFile);
+    }
+    return bRetVal;
+}
+
+/** Save the EEPROM image to a file
+ * @param[in]  pFileName  image file name
+ * @retval  true  image saved
+ */
+bool host_eeprom_Save(const char * pFileName)
+{
+    bool bRetVal = false;
+    FILE * pFile = fopen(pFileName, "wb");
+
+    if (pFile != NULL)
+    {
+        bRetVal = (fwrite(g_au8HostEeprom, 1u, sizeof(g_au8HostEeprom), pFile) == sizeof(g_au8HostEeprom));
+        (void)fclose(pFile);
+    }
+    return bRetVal;
+}
+
+/* EEPROM driver */
+
+void EEPROM_ClearErrorFlags(void)
+{}
+
+bool EEPROM_GetErrorFlags(void)
+{
+    return false;
+}
+
+void EEPROM_WriteWord64_blocking(const uint16_t address, uint16_t* data64bit, uint16_t const write_acces_key)
+{
+    (void)write_acces_key;
+    (void)memcpy(&g_au8HostEeprom[address - EEPROM_START], data64bit, 8u);
+    g_u32HostEepromWrites++;
+}
+
+/** Melexis NVRAM checksum: 16-bit word sum with end-around carry folded to 8 bits */
+uint16_t nvram_CalcCRC(const uint16_t* pu16BeginAddress, const uint16_t u16Length)
+{
+    uint32_t u32Sum = 0u;
+
+    for (uint16_t i = 0u; i < u16Length; i++)
+    {
+        u32Sum += pu16BeginAddress[i];
+    }
+    while ((u32Sum >> 8) != 0u)
+    {
+        u32Sum = (u32Sum & 0xFFu) + (u32Sum >> 8);
+    }
+    return (uint16_t)u32Sum;
+}
+
+/* EOF */
@@ -0,0 +1,35 @@
+/**
+ * @file
+ * @brief Host build EEPROM model
+ * @internal
+ *
+ * @copyright (C) 2025 Melexis N.V.
+ *
+ * Melexis N.V. is supplying this code for use with Melexis N.V. processor based microcontrollers only.
+ *
+ * THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED OR STATUTORY,
+ * INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.  MELEXIS N.V. SHALL NOT IN ANY CIRCUMSTANCES,
+ * BE LIABLE FOR SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON WHATSOEVER.
+ *
+ * @endinternal
+ *
+ * @ingroup host
+ */
+
+#ifndef HOST_EEPROM_H_
+#define HOST_EEPROM_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+extern uint8_t g_au8HostEeprom[];
+extern uint32_t g_u32HostEepromWrites;
+
+void host_eeprom_Erase(void);
+bool host_eeprom_Load(const char * pFileName);
+bool host_eeprom_Save(const char * pFileName);
+
+#endif /* HOST_EEPROM_H_ */
+
+/* EOF */
@@ -0,0 +1,209 @@
+/**
+ * @file
+ * @brief Host build fast math library
+ * @internal
+ *
+ * @copyright (C) 2025 Melexis N.V.
+ *
+ * Melexis N.V. is supplying this code for use with Melexis N.V. processor based microcontrollers only.
+ *
+ * THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED OR STATUTORY,
+ * INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.  MELEXIS N.V. SHALL NOT IN ANY CIRCUMSTANCES,
+ * BE LIABLE FOR SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON WHATSOEVER.
+ *
+ * @endinternal
+ *
+ * @ingroup host
+ *
+ * @details C implementations of the arctangent functions of libfast_math.a. The helpers
+ *          follow the MLX16 assembly of fm_atan2.h instruction by instruction:
+ *          - the ratio is the 32/16 division of (num:den) by den, i.e. one LSB above
+ *            num * 65536 / den, as the assembly does not clear the low word;
+ *          - the direct LUT helper returns the bin centre entry fm_AtanTable_256[idx + 1];
+ *          - the interpolating helper rounds the ratio by half a bin and interpolates
+ *            between the bin centres.
+ *          p_atan2I16() is documented as the assembly version of the signed direct LUT
+ *          function and is modelled as such.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <math.h>
+#include <fm_atan2.h>
+
+/* ---------------------------------------------
+ * Local Variables
+ * --------------------------------------------- */
+
+/** fm_AtanTable_256: atan((k - 0.5) / 256) for k = 0..257 [2pi/65536] */
+static int16_t l_ai16AtanTable[258];
+static bool l_bAtanTableInit = false;
+
+/* ---------------------------------------------
+ * Local Functions
+ * --------------------------------------------- */
+
+/** Fill fm_AtanTable_256, identical to the table of libfast_math.a */
+static void host_AtanTableInit(void)
+{
+    uint16_t k;
+
+    for (k = 0u; k < 258u; k++)
+    {
+        l_ai16AtanTable[k] = (int16_t)lround(atan(((double)k - 0.5) / 256.0) * (32768.0 / M_PI));
+    }
+    l_bAtanTableInit = true;
+}
+
+/** 32/16 bit division of the ratio, num < den */
+static uint16_t host_Atan2Ratio(uint16_t num, uint16_t den)
+{
+    return (uint16_t)((((uint32_t)num << 16) | den) / den);
+}
+
+/** Direct LUT arctangent of num/den, num < den [2pi/65536] */
+static uint16_t host_AtanDirectLut(uint16_t num, uint16_t den)
+{
+    uint16_t u16Idx = (uint16_t)(host_Atan2Ratio(num, den) >> 8);
+
+    return (uint16_t)l_ai16AtanTable[u16Idx + 1u];
+}
+
+/** Interpolated arctangent of num/den, num < den [2pi/65536] */
+static uint16_t host_AtanInterpolation(uint16_t num, uint16_t den)
+{
+    uint32_t u32Ratio = (uint32_t)host_Atan2Ratio(num, den) + 128u;
+    uint16_t u16Idx = (uint16_t)(u32Ratio >> 8);
+    int16_t i16Frac = (int16_t)(u32Ratio & 0xFFu);
+    int16_t i16Delta = (int16_t)(l_ai16AtanTable[u16Idx + 1u] - l_ai16AtanTable[u16Idx]);
+    uint16_t u16Step = (uint16_t)((((uint16_t)(i16Frac * i16Delta) + 128u) >> 8) & 0xFFu);
+
+    return (uint16_t)(l_ai16AtanTable[u16Idx] + u16Step);
+}
+
+/** First quadrant arctangent of y/x [2pi/65536]
+ * @param[in]  y  Y coordinate
+ * @param[in]  x  X coordinate
+ * @param[in]  bInterpolation  false: direct LUT, true: interpolated LUT
+ */
+static int16_t host_Atan2Helper(uint16_t y, uint16_t x, bool bInterpolation)
+{
+    uint16_t u16Result;
+
+    if (l_bAtanTableInit == false)
+    {
+        host_AtanTableInit();
+    }
+    if (x < y)
+    {
+        u16Result = (uint16_t)(0x4000u - (bInterpolation ? host_AtanInterpolation(x, y) : host_AtanDirectLut(x, y)));
+    }
+    else if (x == y)
+    {
+        u16Result = (y == 0u) ? 0u : 0x2000u;
+    }
+    else
+    {
+        u16Result = bInterpolation ? host_AtanInterpolation(y, x) : host_AtanDirectLut(y, x);
+    }
+    return (int16_t)u16Result;
+}
+
+/** Signed arctangent from the first quadrant helper, see fm_Atan2I16InterpolationInlined() */
+static int16_t host_Atan2I16(int16_t y, int16_t x, bool bInterpolation)
+{
+    uint16_t u16Angle;
+
+    if (y < 0)
+    {
+        if (x < 0)
+        {
+            u16Angle = (uint16_t)host_Atan2Helper((uint16_t)-y, (uint16_t)-x, bInterpolation) - 0x8000u;
+        }
+        else
+        {
+            u16Angle = (uint16_t)-host_Atan2Helper((uint16_t)-y, (uint16_t)x, bInterpolation);
+        }
+    }
+    else if (x < 0)
+    {
+        u16Angle = 0x8000u - (uint16_t)host_Atan2Helper((uint16_t)y, (uint16_t)-x, bInterpolation);
+    }
+    else
+    {
+        u16Angle = (uint16_t)host_Atan2Helper((uint16_t)y, (uint16_t)x, bInterpolation);
+    }
+    return (int16_t)u16Angle;
+}
+
+/* ---------------------------------------------
+ * Public Functions Implementation
+ * --------------------------------------------- */
+
+int16_t fm_Atan2HelperDirectLutInlined(uint16_t y, uint16_t x)
+{
+    return host_Atan2Helper(y, x, false);
+}
+
+int16_t fm_Atan2HelperInterpolationInlined(uint16_t y, uint16_t x)
+{
+    return host_Atan2Helper(y, x, true);
+}
+
+int16_t fm_Atan2HelperDirectLutNonInlined(uint16_t y, uint16_t x)
+{
+    return host_Atan2Helper(y, x, false);
+}
+
+int16_t fm_Atan2HelperInterpolationNonInlined(uint16_t y, uint16_t x)
+{
+    return host_Atan2Helper(y, x, true);
+}
+
+int16_t fm_Atan2U16DirectLutInlined(uint16_t y, uint16_t x)
+{
+    return host_Atan2Helper(y, x, false);
+}
+
+int16_t fm_Atan2U16DirectLutNonInlined(uint16_t y, uint16_t x)
+{
+    return host_Atan2Helper(y, x, false);
+}
+
+int16_t fm_Atan2U16InterpolationInlined(uint16_t y, uint16_t x)
+{
+    return host_Atan2Helper(y, x, true);
+}
+
+int16_t fm_Atan2U16InterpolationNonInlined(uint16_t y, uint16_t x)
+{
+    return host_Atan2Helper(y, x, true);
+}
+
+int16_t p_atan2I16(uint16_t y, uint16_t x)
+{
+    return host_Atan2I16((int16_t)y, (int16_t)x, false);
+}
+
+int16_t fm_Atan2I16DirectLutInlined(int16_t y, int16_t x)
+{
+    return host_Atan2I16(y, x, false);
+}
+
+int16_t fm_Atan2I16DirectLutNonInlined(int16_t y, int16_t x)
+{
+    return host_Atan2I16(y, x, false);
+}
+
+int16_t fm_Atan2I16InterpolationInlined(int16_t y, int16_t x)
+{
+    return host_Atan2I16(y, x, true);
+}
+
+int16_t fm_Atan2I16InterpolationNonInlined(int16_t y, int16_t x)
+{
+    return host_Atan2I16(y, x, true);
+}
+
+/* EOF */
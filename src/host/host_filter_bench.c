@@ -0,0 +1,298 @@
+/**
+ * @file
+ * @brief Host build filter_avg benchmark
+ * @internal
+ *
+ * @copyright (C) 2025 Melexis N.V.
+ *
+ * Melexis N.V. is supplying this code for use with Melexis N.V. processor based microcontrollers only.
+ *
+ * THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED OR STATUTORY,
+ * INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.  MELEXIS N.V. SHALL NOT IN ANY CIRCUMSTANCES,
+ * BE LIABLE FOR SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON WHATSOEVER.
+ *
+ * @endinternal
+ *
+ * @ingroup host
+ *
+ * @details Compares the update paths of the filter_avg library for the channels of
+ *          adc_raw_update() (ADC_FAST_FILTER in app_sensor.c):
+ *          - object: one FILTER_AVG_CalcMovAvg() call per channel, one divU16_U32byU16()
+ *            per channel;
+ *          - bank: FILTER_AVG_CalcBank() over all channels, shift instead of divide;
+ *          - bank exp: FILTER_AVG_CalcBankExp() over all channels, no sample buffer.
+ *          The object and bank outputs are checked to be identical for the same input. The
+ *          time is measured on the build machine and only indicates the relative cost, on
+ *          the MLX16 the bank path additionally saves the divu of every channel.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <filter_avg.h>
+
+/* ---------------------------------------------
+ * Local Defines
+ * --------------------------------------------- */
+
+/** maximum number of channels */
+#define C_BENCH_MAX_CHANNELS    16u
+/** filter length [samples] */
+#define C_BENCH_SIZE            8u
+
+/* ---------------------------------------------
+ * Local Types
+ * --------------------------------------------- */
+
+/** filters under test, every path filters the same channels */
+typedef struct
+{
+    FILTER_AVG_Object_t asObject[C_BENCH_MAX_CHANNELS];
+    uint16_t au16ObjectRaw[C_BENCH_MAX_CHANNELS][C_BENCH_SIZE];
+    FILTER_AVG_Bank_t sBank;
+    uint16_t au16BankAvg[C_BENCH_MAX_CHANNELS];
+    uint32_t au32BankAvgxN[C_BENCH_MAX_CHANNELS];
+    uint16_t au16BankRaw[C_BENCH_SIZE * C_BENCH_MAX_CHANNELS];
+    FILTER_AVG_Bank_t sBankExp;
+    uint16_t au16BankExpAvg[C_BENCH_MAX_CHANNELS];
+    uint32_t au32BankExpAvgxN[C_BENCH_MAX_CHANNELS];
+} BenchFilters_t;
+
+/* ---------------------------------------------
+ * Local Variables
+ * --------------------------------------------- */
+
+static BenchFilters_t l_sFilters;
+static volatile uint16_t l_u16Sink;
+
+/* ---------------------------------------------
+ * Local Functions
+ * --------------------------------------------- */
+
+static void bench_Init(BenchFilters_t * pFilters, uint16_t u16Channels)
+{
+    uint16_t i;
+
+    memset(pFilters, 0, sizeof(*pFilters));
+    for (i = 0u; i < u16Channels; i++)
+    {
+        pFilters->asObject[i].pu16Raw = &pFilters->au16ObjectRaw[i][0];
+        pFilters->asObject[i].u16Size = C_BENCH_SIZE;
+        (void)FILTER_AVG_Init(&pFilters->asObject[i]);
+    }
+    pFilters->sBank.pu16MovAvg = &pFilters->au16BankAvg[0];
+    pFilters->sBank.pu32MovAvgxN = &pFilters->au32BankAvgxN[0];
+    pFilters->sBank.pu16Raw = &pFilters->au16BankRaw[0];
+    pFilters->sBank.u16NrOfChannels = u16Channels;
+    pFilters->sBank.u16Size = C_BENCH_SIZE;
+    (void)FILTER_AVG_InitBank(&pFilters->sBank);
+    pFilters->sBankExp.pu16MovAvg = &pFilters->au16BankExpAvg[0];
+    pFilters->sBankExp.pu32MovAvgxN = &pFilters->au32BankExpAvgxN[0];
+    pFilters->sBankExp.pu16Raw = NULL;
+    pFilters->sBankExp.u16NrOfChannels = u16Channels;
+    pFilters->sBankExp.u16Size = C_BENCH_SIZE;
+    (void)FILTER_AVG_InitBank(&pFilters->sBankExp);
+}
+
+/** Pseudo random 12 bit adc sample */
+static uint16_t bench_Sample(uint32_t * pu32Seed)
+{
+    *pu32Seed = (*pu32Seed * 1103515245u) + 12345u;
+    return (uint16_t)((*pu32Seed >> 16) & 0x0FFFu);
+}
+
+static double bench_Now(void)
+{
+    struct timespec sTime;
+
+    (void)clock_gettime(CLOCK_MONOTONIC, &sTime);
+    return ((double)sTime.tv_sec * 1e9) + (double)sTime.tv_nsec;
+}
+
+/** Check that the bank and the objects deliver the same moving average
+ * @return  number of updates with a different output
+ */
+static uint32_t bench_Check(uint16_t u16Channels, uint32_t u32Updates)
+{
+    uint16_t au16Raw[C_BENCH_MAX_CHANNELS];
+    uint32_t u32Seed = 1u;
+    uint32_t u32Errors = 0u;
+    uint32_t n;
+    uint16_t i;
+
+    bench_Init(&l_sFilters, u16Channels);
+    for (n = 0u; n < u32Updates; n++)
+    {
+        bool bSame = true;
+
+        for (i = 0u; i < u16Channels; i++)
+        {
+            au16Raw[i] = bench_Sample(&u32Seed);
+            FILTER_AVG_CalcMovAvg(&l_sFilters.asObject[i], au16Raw[i]);
+        }
+        FILTER_AVG_CalcBank(&l_sFilters.sBank, au16Raw);
+        for (i = 0u; i < u16Channels; i++)
+        {
+            if (l_sFilters.au16BankAvg[i] != l_sFilters.asObject[i].u16MovAvg)
+            {
+                bSame = false;
+            }
+        }
+        if (bSame == false)
+        {
+            u32Errors++;
+        }
+    }
+    return u32Errors;
+}
+
+/** Time one of the update paths
+ * @param[in]  u16Path      0: objects, 1: bank, 2: bank exp
+ * @param[in]  u16Channels  number of channels
+ * @param[in]  u32Updates   number of updates
+ * @return  time per update of all channels [ns]
+ */
+static double bench_Time(uint16_t u16Path, uint16_t u16Channels, uint32_t u32Updates)
+{
+    static uint16_t au16Raw[1024u][C_BENCH_MAX_CHANNELS];
+    uint32_t u32Seed = 1u;
+    double dStart;
+    uint32_t n;
+    uint16_t i;
+
+    bench_Init(&l_sFilters, u16Channels);
+    for (n = 0u; n < 1024u; n++)
+    {
+        for (i = 0u; i < u16Channels; i++)
+        {
+            au16Raw[n][i] = bench_Sample(&u32Seed);
+        }
+    }
+
+    dStart = bench_Now();
+    for (n = 0u; n < u32Updates; n++)
+    {
+        const uint16_t * pu16Raw = au16Raw[n & 1023u];
+
+        if (u16Path == 0u)
+        {
+            for (i = 0u; i < u16Channels; i++)
+            {
+                FILTER_AVG_CalcMovAvg(&l_sFilters.asObject[i], pu16Raw[i]);
+            }
+            l_u16Sink = l_sFilters.asObject[0].u16MovAvg;
+        }
+        else if (u16Path == 1u)
+        {
+            FILTER_AVG_CalcBank(&l_sFilters.sBank, pu16Raw);
+            l_u16Sink = l_sFilters.au16BankAvg[0];
+        }
+        else
+        {
+            FILTER_AVG_CalcBankExp(&l_sFilters.sBankExp, pu16Raw);
+            l_u16Sink = l_sFilters.au16BankExpAvg[0];
+        }
+    }
+    return (bench_Now() - dStart) / (double)u32Updates;
+}
+
+/** Step response: updates until the output reaches 95% of a full scale step */
+static uint16_t bench_Settle(bool bExp)
+{
+    static const uint16_t au16Step[1] = {4000u};
+    uint16_t n;
+
+    bench_Init(&l_sFilters, 1u);
+    for (n = 1u; n < 1000u; n++)
+    {
+        uint16_t u16Out;
+
+        if (bExp)
+        {
+            FILTER_AVG_CalcBankExp(&l_sFilters.sBankExp, au16Step);
+            u16Out = l_sFilters.au16BankExpAvg[0];
+        }
+        else
+        {
+            FILTER_AVG_CalcBank(&l_sFilters.sBank, au16Step);
+            u16Out = l_sFilters.au16BankAvg[0];
+        }
+        if (u16Out >= 3800u)
+        {
+            break;
+        }
+    }
+    return n;
+}
+
+static void bench_Usage(const char * pName)
+{
+    printf("Usage: %s [-c channels] [-n updates]\n", pName);
+    printf("  -c channels   single number of channels (1..%u) instead of 5 and 9\n", C_BENCH_MAX_CHANNELS);
+    printf("  -n updates    number of timed updates (default 10000000)\n");
+}
+
+/* ---------------------------------------------
+ * Public Functions Implementation
+ * --------------------------------------------- */
+
+int main(int argc, char * argv[])
+{
+    static const uint16_t au16Channels[] = {5u, 9u};
+    static const char * const apPath[] = {"object", "bank", "bank exp"};
+    uint32_t u32Updates = 10000000u;
+    int32_t i32Channels = 0;
+    uint16_t i, k;
+
+    for (i = 1u; i < (uint16_t)argc; i++)
+    {
+        if ((strcmp(argv[i], "-c") == 0) && ((i + 1) < argc))
+        {
+            i32Channels = (int32_t)strtol(argv[++i], NULL, 0);
+        }
+        else if ((strcmp(argv[i], "-n") == 0) && ((i + 1) < argc))
+        {
+            u32Updates = (uint32_t)strtoul(argv[++i], NULL, 0);
+        }
+        else
+        {
+            bench_Usage(argv[0]);
+            return 1;
+        }
+    }
+    if ((i32Channels < 0) || (i32Channels > (int32_t)C_BENCH_MAX_CHANNELS) || (u32Updates == 0u))
+    {
+        bench_Usage(argv[0]);
+        return 1;
+    }
+
+    printf("Update of all channels, %u samples per channel\n", C_BENCH_SIZE);
+    printf("  %-10s %8s %10s %10s %8s\n", "path", "channels", "divisions", "host[ns]", "check");
+    for (i = 0u; i < (sizeof(au16Channels) / sizeof(au16Channels[0])); i++)
+    {
+        uint16_t u16Channels = (i32Channels != 0) ? (uint16_t)i32Channels : au16Channels[i];
+        uint32_t u32Errors = bench_Check(u16Channels, 100000u);
+
+        for (k = 0u; k < 3u; k++)
+        {
+            printf("  %-10s %8u %10u %10.1f %8s\n", apPath[k], u16Channels, (k == 0u) ? u16Channels : 0u,
+                   bench_Time(k, u16Channels, u32Updates),
+                   (k == 1u) ? ((u32Errors == 0u) ? "same" : "DIFF") : "");
+        }
+        if (i32Channels != 0)
+        {
+            break;
+        }
+    }
+
+    printf("\nStep response to 95%%\n");
+    printf("  %-10s %3u updates\n", "bank", bench_Settle(false));
+    printf("  %-10s %3u updates\n", "bank exp", bench_Settle(true));
+    return 0;
+}
+
+/* EOF */
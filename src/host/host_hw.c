@@ -0,0 +1,395 @@
+/**
+ * @file
+ * @brief Host build peripheral model
+ * @internal
+ *
+ * @copyright (C) 2025 Melexis N.V.
+ *
+ * Melexis N.V. is supplying this code for use with Melexis N.V. processor based microcontrollers only.
+ *
+ * THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED OR STATUTORY,
+ * INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.  MELEXIS N.V. SHALL NOT IN ANY CIRCUMSTANCES,
+ * BE LIABLE FOR SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON WHATSOEVER.
+ *
+ * @endinternal
+ *
+ * @ingroup host
+ *
+ * @details Implements the adc, pwm, protection, diagnostic, lin and uart module interfaces
+ *          used by the application, plus the MLX16 system functions the platform headers
+ *          only declare when building with UNITTEST.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <time.h>
+#include <lin_api.h>
+#include <ctimerlib.h>
+#include <lib_wdg.h>
+#include <lib_gpio.h>
+#include <lib_softio.h>
+#include <builtin_mlx16.h>
+
+#include "adc.h"
+#include "pwm.h"
+#include "protection.h"
+#include "diagnostic.h"
+#include "lin22.h"
+#include "uart.h"
+#include "host_hw.h"
+
+/* ---------------------------------------------
+ * Public Variables
+ * --------------------------------------------- */
+
+volatile uint16_t g_u16HostIoDummy;       /**< sink of the IO port accesses */
+HostPwm_t g_sHostPwm;                     /**< last pwm output request */
+bool g_bHostSleep = false;                /**< application requested to enter sleep */
+
+/* adc driver */
+volatile uint16_t dBase[ADC_SAMPLE_VS_2 + 1u]; /**< adc samples as written by the adc DMA */
+int16_t i16MotorCurrentZeroOffset = 0;    /**< motor current zero offset [LSB] */
+
+/* protection module */
+ErrVoltage_t g_e8ErrorVoltage = C_ERR_VOLTAGE_IN_RANGE;
+ErrTemp_t g_e8ErrorOverTemperature = C_ERR_TEMP_NO;
+ErrShort_t g_e8ShortOcc = C_ERR_SHORT_NO;
+uint8_t g_e8OverCurrent = 0u;
+
+/* GMR bridge leg forced to a level, see host_adc_SetGmrLegFault() */
+static const uint8_t l_au8GmrLegSample[4] = {ADC_SAMPLE_GMR_IO1, ADC_SAMPLE_GMR_IO2, ADC_SAMPLE_GMR_IO3, ADC_SAMPLE_GMR_IO4};
+static uint8_t l_u8GmrFaultLeg = 0u;
+static uint16_t l_u16GmrFaultRaw = 0u;
+
+/* lin module */
+volatile l_signals_t l_signals;
+volatile l_sl1_flags_t l_sl1_flags;
+uint8_t g_u8LinErrorCnt = 0u;
+uint8_t g_u8LinErrorCode = 0u;
+
+/* ---------------------------------------------
+ * Public Functions Implementation
+ * --------------------------------------------- */
+
+/** Reset the peripheral model to a powered, idle node: 12V, 25C, ignition on, no current */
+void host_hw_Init(void)
+{
+    (void)memset((void *)dBase, 0, sizeof(dBase));
+    (void)memset(&g_sHostPwm, 0, sizeof(g_sHostPwm));
+    g_bHostSleep = false;
+    l_u8GmrFaultLeg = 0u;
+
+    host_adc_SetSupplyVoltage(1200u);
+    host_adc_SetMotorCurrent(0u);
+    host_adc_SetChipTemperature(25);
+    host_adc_SetIgnition(true);
+    host_adc_SetGmr(0, 0x200);
+    dBase[ADC_SAMPLE_VDDA] = (uint16_t)((3300uL * 1024uL) / 660uL / 10uL); /* 3.3V, see adc_ConvertToVoltage() */
+}
+
+/** Set the supply voltages VS and VSM
+ * @param[in]  u16Voltage  voltage [10mV]
+ */
+void host_adc_SetSupplyVoltage(uint16_t u16Voltage)
+{
+    uint32_t u32Raw = ((uint32_t)u16Voltage * C_HOST_ADC_FULL_SCALE) / C_HOST_VS_FULL_SCALE;
+
+    if (u32Raw > C_HOST_ADC_FULL_SCALE)
+    {
+        u32Raw = C_HOST_ADC_FULL_SCALE;
+    }
+    dBase[ADC_SAMPLE_VS] = (uint16_t)u32Raw;
+    dBase[ADC_SAMPLE_VS_2] = (uint16_t)u32Raw;
+    dBase[ADC_SAMPLE_VSM] = (uint16_t)u32Raw;
+}
+
+/** Set the motor (shunt) current
+ * @param[in]  u16Current  current [mA]
+ */
+void host_adc_SetMotorCurrent(uint16_t u16Current)
+{
+    uint32_t u32Raw = ((uint32_t)u16Current * C_HOST_ADC_FULL_SCALE) / C_HOST_CURR_FULL_SCALE;
+
+    if (u32Raw > C_HOST_ADC_FULL_SCALE)
+    {
+        u32Raw = C_HOST_ADC_FULL_SCALE;
+    }
+    dBase[ADC_SAMPLE_CURR] = (uint16_t)u32Raw + (uint16_t)i16MotorCurrentZeroOffset;
+    dBase[ADC_SAMPLE_CURR_2] = dBase[ADC_SAMPLE_CURR];
+}
+
+/** Set the chip temperature
+ * @param[in]  i16Temperature  temperature [C]
+ */
+void host_adc_SetChipTemperature(int16_t i16Temperature)
+{
+    dBase[ADC_SAMPLE_TEMP] = (uint16_t)(C_HOST_TEMP_RAW_AT_0C + i16Temperature);
+}
+
+/** Set the ignition input
+ * @param[in]  bOn  true: 12V, false: 0V
+ */
+void host_adc_SetIgnition(bool bOn)
+{
+    dBase[ADC_SAMPLE_IGN] = bOn ? C_HOST_IGN_RAW_ON : 0u;
+}
+
+/** Set the GMR bridge outputs
+ *
+ * The differential signals are split symmetrically around the bridge common mode,
+ * the application reads them back as (p - n), see get_gmr_sine_output().
+ * @param[in]  i16Sin  differential sine output [LSB]
+ * @param[in]  i16Cos  differential cosine output [LSB]
+ */
+void host_adc_SetGmr(int16_t i16Sin, int16_t i16Cos)
+{
+    dBase[ADC_SAMPLE_GMR_IO4] = (uint16_t)(C_HOST_GMR_COMMON_MODE + (i16Sin / 2));
+    dBase[ADC_SAMPLE_GMR_IO2] = (uint16_t)(C_HOST_GMR_COMMON_MODE - (i16Sin - (i16Sin / 2)));
+    dBase[ADC_SAMPLE_GMR_IO3] = (uint16_t)(C_HOST_GMR_COMMON_MODE + (i16Cos / 2));
+    dBase[ADC_SAMPLE_GMR_IO1] = (uint16_t)(C_HOST_GMR_COMMON_MODE - (i16Cos - (i16Cos / 2)));
+    if (l_u8GmrFaultLeg != 0u)
+    {
+        dBase[l_au8GmrLegSample[l_u8GmrFaultLeg - 1u]] = l_u16GmrFaultRaw;
+    }
+}
+
+/** Force a GMR bridge leg to a level, as an open or shorted leg, from the next
+ * host_adc_SetGmr() on
+ * @param[in]  u8Leg    GMR IO 1..4, 0: no fault
+ * @param[in]  u16Raw   adc sample of the leg [LSB]
+ */
+void host_adc_SetGmrLegFault(uint8_t u8Leg, uint16_t u16Raw)
+{
+    l_u8GmrFaultLeg = u8Leg;
+    l_u16GmrFaultRaw = u16Raw;
+}
+
+/** Receive a VPC_Fwv_Ctrl master frame
+ * @param[in]  u8TargetMode  target mode, C_MODE_A or C_MODE_B
+ * @param[in]  bMoveEnable   move enable
+ * @param[in]  bInitial      initialization (calibration) request
+ */
+void host_lin_SendCtrl(uint8_t u8TargetMode, bool bMoveEnable, bool bInitial)
+{
+    l_u8_wr_Fwv_Target_Mode(u8TargetMode);
+    l_bool_wr_Fwv_MoveEnable(bMoveEnable);
+    l_bool_wr_Fwv_Initial(bInitial);
+    l_bool_wr_Fwv_ForcedDiag(false);
+    l_sl1_flags.mapped.f_VPC_Fwv_Ctrl = true;
+}
+
+/* adc driver */
+
+void adc_Init(void)
+{}
+
+void adc_Close(void)
+{}
+
+void adc_Start(bool bWait)
+{
+    (void)bWait;
+}
+
+void adc_Stop(void)
+{}
+
+void adc_Shunt_OffsetCalib(void)
+{}
+
+int16_t adc_ConvertToTchip(uint16_t u16AdcVal)
+{
+    return (int16_t)u16AdcVal - C_HOST_TEMP_RAW_AT_0C;
+}
+
+int16_t adc_ConvertToVsmFiltered(uint16_t u16AdcVal)
+{
+    return adc_ConvertToVsupply(u16AdcVal);
+}
+
+int16_t adc_ConvertToVsupply(uint16_t u16AdcVal)
+{
+    return (int16_t)(((uint32_t)u16AdcVal * C_HOST_VS_FULL_SCALE) / C_HOST_ADC_FULL_SCALE);
+}
+
+int16_t adc_ConvertToVphase(uint16_t u16AdcVal)
+{
+    return adc_ConvertToVsupply(u16AdcVal);
+}
+
+int16_t adc_ConvertToVio(uint16_t u16AdcVal)
+{
+    return adc_ConvertToVoltage(u16AdcVal);
+}
+
+int16_t adc_ConvertToVoltage(uint16_t u16AdcVal)
+{
+    return (int16_t)(((uint32_t)u16AdcVal * 660u) / 1024u);
+}
+
+int16_t adc_ConvertToCurrent(uint16_t u16AdcVal)
+{
+    return (int16_t)(((uint32_t)u16AdcVal * C_HOST_CURR_FULL_SCALE) / C_HOST_ADC_FULL_SCALE);
+}
+
+/* pwm driver */
+
+void pwm_Init(void)
+{
+    pwm_Off();
+}
+
+void pwm_Start(uint8_t dir, uint16_t u16DutyCycle)
+{
+    pwm_SetDutyCycle(dir, u16DutyCycle);
+}
+
+void pwm_SetDutyCycle(uint8_t dir, uint16_t u16DutyCycle)
+{
+    g_sHostPwm.e8Mode = C_HOST_PWM_RUN;
+    g_sHostPwm.u8Dir = dir;
+    g_sHostPwm.u16Duty = u16DutyCycle;
+}
+
+void pwm_SetMaxDutyCycle(uint16_t u16DutyCycle)
+{
+    (void)u16DutyCycle;
+}
+
+void pwm_Stop(void)
+{
+    g_sHostPwm.e8Mode = C_HOST_PWM_STOP;
+    g_sHostPwm.u16Duty = 0u;
+}
+
+void pwm_Brake(uint16_t u16Strength)
+{
+    static uint16_t u16BrakeAcc = 0u;
+
+    /* same modulation as pwm.c */
+    if (u16Strength >= C_PWMOUT_MAX_DUTY)
+    {
+        u16BrakeAcc = 0u;
+        pwm_Stop();
+    }
+    else
+    {
+        u16BrakeAcc += u16Strength;
+        if (u16BrakeAcc >= C_PWMOUT_MAX_DUTY)
+        {
+            u16BrakeAcc -= C_PWMOUT_MAX_DUTY;
+            pwm_Stop();
+        }
+        else
+        {
+            pwm_Off();
+        }
+    }
+}
+
+void pwm_Off(void)
+{
+    g_sHostPwm.e8Mode = C_HOST_PWM_OFF;
+    g_sHostPwm.u16Duty = 0u;
+}
+
+void pwm_Disable(void)
+{
+    pwm_Off();
+}
+
+/* protection and diagnostic */
+
+void protection_Init(void)
+{}
+
+void protection_Task(void)
+{}
+
+void DIAGNOSTIC_Reset(void)
+{}
+
+/* lin driver */
+
+void lin22_Init(void)
+{}
+
+void lin22_Stop(void)
+{}
+
+void lin22_BackgroundHandler(void)
+{}
+
+void lin22_GotoSleep(void)
+{
+    g_bHostSleep = true;
+}
+
+/* uart */
+
+void uartInit(void)
+{}
+
+void uartTask(void)
+{}
+
+/* MLX16 system functions */
+
+void WDG_conditionalAwdRefresh(void)
+{}
+
+void WDG_disableIwdIt(void)
+{}
+
+void gpio_io0HvEnable(void)
+{}
+
+uint8_t softio_get(GpioIo_t IO)
+{
+    (void)IO;
+    return 1u;
+}
+
+void builtin_mlx16_enter_user_mode(void)
+{}
+
+uint16_t builtin_mlx16_get_status(void)
+{
+    return 0u;
+}
+
+uint16_t mlx16_di_enter_system_mode(void)
+{
+    return 0u;
+}
+
+uint16_t mlx16_di_keep_mode(void)
+{
+    return 0u;
+}
+
+void mlx16_restore_status(const uint16_t* pm)
+{
+    (void)pm;
+}
+
+/* CTIMER0, free-running on the host monotonic clock for the profiler */
+
+void CTimer0_AutoloadInit(CTimer_Clockdivider_t divider, uint16_t cmpb)
+{
+    (void)divider;
+    (void)cmpb;
+}
+
+uint16_t CTimer0_Counter(void)
+{
+    struct timespec sNow;
+
+    (void)clock_gettime(CLOCK_MONOTONIC, &sNow);
+    /* FPLL [kHz] CPU cycles per ms */
+    return (uint16_t)((((uint64_t)sNow.tv_sec * 1000000000u) + (uint64_t)sNow.tv_nsec) * FPLL / 1000000u);
+}
+
+/* EOF */
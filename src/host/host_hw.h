@@ -0,0 +1,90 @@
+/**
+ * @file
+ * @brief Host build peripheral model
+ * @internal
+ *
+ * @copyright (C) 2025 Melexis N.V.
+ *
+ * Melexis N.V. is supplying this code for use with Melexis N.V. processor based microcontrollers only.
+ *
+ * THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED OR STATUTORY,
+ * INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.  MELEXIS N.V. SHALL NOT IN ANY CIRCUMSTANCES,
+ * BE LIABLE FOR SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON WHATSOEVER.
+ *
+ * @endinternal
+ *
+ * @ingroup host
+ *
+ * @details Replaces the adc, pwm, protection, lin and uart drivers of the application with
+ *          a simple model. The analog inputs are set in physical units and converted to the
+ *          raw adc samples the application reads from dBase[]; the pwm outputs are recorded
+ *          so that a plant model or a test can read them back.
+ */
+
+#ifndef HOST_HW_H_
+#define HOST_HW_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/* ---------------------------------------------
+ * Public Defines
+ * --------------------------------------------- */
+
+/** adc full scale [LSB] */
+#define C_HOST_ADC_FULL_SCALE       1023u
+/** supply voltage at adc full scale [10mV] (30mV / LSB) */
+#define C_HOST_VS_FULL_SCALE        3069u
+/** motor current at adc full scale [mA] (4mA / LSB) */
+#define C_HOST_CURR_FULL_SCALE      4092u
+/** chip temperature adc sample at 0C, 1C / LSB */
+#define C_HOST_TEMP_RAW_AT_0C       0x240
+/** common mode of the GMR bridge outputs [LSB] */
+#define C_HOST_GMR_COMMON_MODE      0x200
+/** ignition adc sample at 12V, see IGNconversionMap in app_sensor.c */
+#define C_HOST_IGN_RAW_ON           0x178u
+
+/* ---------------------------------------------
+ * Public Enumerations
+ * --------------------------------------------- */
+
+/** pwm output state */
+typedef enum
+{
+    C_HOST_PWM_OFF = 0u, /**< all phases tristate */
+    C_HOST_PWM_STOP,     /**< all phases driven low (brake) */
+    C_HOST_PWM_RUN       /**< one phase modulated, the other low */
+} HostPwmMode_t;
+
+/** pwm output snapshot */
+typedef struct
+{
+    HostPwmMode_t e8Mode; /**< output state */
+    uint8_t u8Dir;        /**< direction, see tMotDirection */
+    uint16_t u16Duty;     /**< duty cycle [0..C_PWMOUT_MAX_DUTY] */
+} HostPwm_t;
+
+/* ---------------------------------------------
+ * Public Variables
+ * --------------------------------------------- */
+
+extern HostPwm_t g_sHostPwm;
+extern bool g_bHostSleep;
+
+/* ---------------------------------------------
+ * Public Function Declarations
+ * --------------------------------------------- */
+
+void host_hw_Init(void);
+void host_adc_SetSupplyVoltage(uint16_t u16Voltage);
+void host_adc_SetMotorCurrent(uint16_t u16Current);
+void host_adc_SetChipTemperature(int16_t i16Temperature);
+void host_adc_SetIgnition(bool bOn);
+void host_adc_SetGmr(int16_t i16Sin, int16_t i16Cos);
+void host_adc_SetGmrLegFault(uint8_t u8Leg, uint16_t u16Raw);
+void host_lin_SendCtrl(uint8_t u8TargetMode, bool bMoveEnable, bool bInitial);
+
+#endif /* HOST_HW_H_ */
+
+/* EOF */
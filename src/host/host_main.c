@@ -0,0 +1,210 @@
+/**
+ * @file
+ * @brief Host build simulation driver
+ * @internal
+ *
+ * @copyright (C) 2025 Melexis N.V.
+ *
+ * Melexis N.V. is supplying this code for use with Melexis N.V. processor based microcontrollers only.
+ *
+ * THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED OR STATUTORY,
+ * INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.  MELEXIS N.V. SHALL NOT IN ANY CIRCUMSTANCES,
+ * BE LIABLE FOR SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON WHATSOEVER.
+ *
+ * @endinternal
+ *
+ * @ingroup host
+ *
+ * @details Runs main_Init() once and then, for every simulated core timer period
+ *          (CT_PERIODIC_RATE), the software timer interrupt followed by one pass of
+ *          main_Task(). The 100us motor control and 1ms application ticks are thereby
+ *          executed in a deterministic order. At the end the simulated tick rate and the
+ *          host cost per tick are reported, split in 100us-only ticks and ticks that also
+ *          run the 1ms application tasks.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <swtimer.h>
+#include <swtimer_config.h>
+
+#include "system.h"
+#include "fw_ints.h"
+#include "AppValve.h"
+#include "dcm_driver.h"
+#include "host_hw.h"
+#include "host_eeprom.h"
+
+/* ---------------------------------------------
+ * Local Defines
+ * --------------------------------------------- */
+
+/** default simulated time [ms] */
+#define C_HOST_DEFAULT_TIME_MS  10000u
+
+/** number of ticks per millisecond */
+#define C_HOST_TICKS_PER_MS     (1000u / CT_PERIODIC_RATE)
+
+/* ---------------------------------------------
+ * Local Types
+ * --------------------------------------------- */
+
+/** host cost statistics of one kind of tick */
+typedef struct
+{
+    uint64_t u64Count;  /**< number of ticks */
+    uint64_t u64Sum;    /**< total cost [ns] */
+    uint64_t u64Min;    /**< minimum cost [ns] */
+    uint64_t u64Max;    /**< maximum cost [ns] */
+} HostTickStat_t;
+
+/* ---------------------------------------------
+ * Local Variables
+ * --------------------------------------------- */
+
+static HostTickStat_t l_sStatMotCtrl;   /**< ticks running the 100us task only */
+static HostTickStat_t l_sStatAppCtrl;   /**< ticks also running the 1ms tasks */
+
+/* ---------------------------------------------
+ * Local Functions
+ * --------------------------------------------- */
+
+static uint64_t host_GetTimeNs(void)
+{
+    struct timespec sTime;
+
+    (void)clock_gettime(CLOCK_MONOTONIC, &sTime);
+    return ((uint64_t)sTime.tv_sec * 1000000000uLL) + (uint64_t)sTime.tv_nsec;
+}
+
+static void host_StatAdd(HostTickStat_t * pStat, uint64_t u64Cost)
+{
+    if ((pStat->u64Count == 0u) || (u64Cost < pStat->u64Min))
+    {
+        pStat->u64Min = u64Cost;
+    }
+    if (u64Cost > pStat->u64Max)
+    {
+        pStat->u64Max = u64Cost;
+    }
+    pStat->u64Sum += u64Cost;
+    pStat->u64Count++;
+}
+
+static void host_StatPrint(const char * pName, const HostTickStat_t * pStat)
+{
+    if (pStat->u64Count != 0u)
+    {
+        printf("  %-22s %10llu ticks  avg %7.1f ns  min %6llu ns  max %8llu ns\n",
+               pName,
+               (unsigned long long)pStat->u64Count,
+               (double)pStat->u64Sum / (double)pStat->u64Count,
+               (unsigned long long)pStat->u64Min,
+               (unsigned long long)pStat->u64Max);
+    }
+}
+
+/** Simulate one core timer period
+ * @param[in]  u32Tick  tick number since start-up
+ */
+static void host_Tick(uint32_t u32Tick)
+{
+    uint64_t u64Start = host_GetTimeNs();
+
+    _STIMER_INT();
+    main_Task();
+
+    uint64_t u64Cost = host_GetTimeNs() - u64Start;
+
+    if ((u32Tick % C_HOST_TICKS_PER_MS) == (C_HOST_TICKS_PER_MS - 1u))
+    {
+        host_StatAdd(&l_sStatAppCtrl, u64Cost);
+    }
+    else
+    {
+        host_StatAdd(&l_sStatMotCtrl, u64Cost);
+    }
+}
+
+static void host_Usage(const char * pName)
+{
+    printf("Usage: %s [-t time_ms] [-e eeprom.bin]\n", pName);
+    printf("  -t time_ms    simulated time in ms (default %u)\n", C_HOST_DEFAULT_TIME_MS);
+    printf("  -e file       EEPROM image, loaded at start-up when present and saved at exit\n");
+}
+
+/* ---------------------------------------------
+ * Public Functions Implementation
+ * --------------------------------------------- */
+
+int main(int argc, char * argv[])
+{
+    uint32_t u32TimeMs = C_HOST_DEFAULT_TIME_MS;
+    const char * pEepromFile = NULL;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if ((strcmp(argv[i], "-t") == 0) && ((i + 1) < argc))
+        {
+            u32TimeMs = (uint32_t)strtoul(argv[++i], NULL, 0);
+        }
+        else if ((strcmp(argv[i], "-e") == 0) && ((i + 1) < argc))
+        {
+            pEepromFile = argv[++i];
+        }
+        else
+        {
+            host_Usage(argv[0]);
+            return 1;
+        }
+    }
+
+    host_eeprom_Erase();
+    if ((pEepromFile != NULL) && host_eeprom_Load(pEepromFile))
+    {
+        printf("EEPROM image restored from %s\n", pEepromFile);
+    }
+    host_hw_Init();
+
+    main_Init();
+
+    uint32_t u32Ticks = u32TimeMs * C_HOST_TICKS_PER_MS;
+    uint32_t u32Tick;
+    uint64_t u64Start = host_GetTimeNs();
+
+    for (u32Tick = 0u; (u32Tick < u32Ticks) && !g_bHostSleep; u32Tick++)
+    {
+        host_Tick(u32Tick);
+    }
+
+    double dWall = (double)(host_GetTimeNs() - u64Start) * 1e-9;
+    double dSim = (double)u32Tick * CT_PERIODIC_RATE * 1e-6;
+
+    printf("Simulated %.3f s (%lu ticks of %u us) in %.3f s host time%s\n",
+           dSim, (unsigned long)u32Tick, CT_PERIODIC_RATE, dWall,
+           g_bHostSleep ? ", stopped: node entered sleep" : "");
+    if (dWall > 0.0)
+    {
+        printf("  %.0f simulated ticks/s, %.1fx real time\n", (double)u32Tick / dWall, dSim / dWall);
+    }
+    printf("Host cost per tick (including timer interrupt):\n");
+    host_StatPrint("100us tick", &l_sStatMotCtrl);
+    host_StatPrint("100us + 1ms tick", &l_sStatAppCtrl);
+    printf("Final state: valve mode %u, motor state %u, position %u, EEPROM page writes %lu\n",
+           (unsigned)get_valve_mode(), (unsigned)MotGetState(), (unsigned)MotGetCurrentPosition(),
+           (unsigned long)g_u32HostEepromWrites);
+
+    if ((pEepromFile != NULL) && !host_eeprom_Save(pEepromFile))
+    {
+        printf("Failed to save the EEPROM image to %s\n", pEepromFile);
+    }
+
+    return 0;
+}
+
+/* EOF */
@@ -0,0 +1,163 @@
+/**
+ * @file
+ * @brief Host build math library
+ * @internal
+ *
+ * @copyright (C) 2025 Melexis N.V.
+ *
+ * Melexis N.V. is supplying this code for use with Melexis N.V. processor based microcontrollers only.
+ *
+ * THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED OR STATUTORY,
+ * INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.  MELEXIS N.V. SHALL NOT IN ANY CIRCUMSTANCES,
+ * BE LIABLE FOR SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON WHATSOEVER.
+ *
+ * @endinternal
+ *
+ * @ingroup host
+ *
+ * @details C reference implementations of the math library functions used by the
+ *          application and the BU-libraries. The MLX16 library (libmath.a) is only
+ *          available for the target.
+ *
+ *          atan2I16() follows the libmath.a code of the target listing step by step, so the
+ *          host build sees the same angle quantization as the target.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <math.h>
+#include <mathlib.h>
+#include <dsp.h>
+
+/* ---------------------------------------------
+ * Local Variables
+ * --------------------------------------------- */
+
+/** libmath.a ATAN_LUT: atan(k/256) for k = 0..257, 4 LSB per 2pi/65536 */
+static uint16_t l_au16AtanLut[258];
+static bool l_bAtanLutInit = false;
+
+/* ---------------------------------------------
+ * Local Functions
+ * --------------------------------------------- */
+
+/** Fill the ATAN_LUT, identical to the table linked into the target */
+static void host_AtanLutInit(void)
+{
+    uint16_t k;
+
+    for (k = 0u; k < 258u; k++)
+    {
+        l_au16AtanLut[k] = (uint16_t)lround(4.0 * atan((double)k / 256.0) * (32768.0 / M_PI));
+    }
+    l_bAtanLutInit = true;
+}
+
+/** atan2_helper: atan(y/x) for y < x, first octant [2pi/65536] */
+static uint16_t host_Atan2Helper(uint16_t y, uint16_t x)
+{
+    uint16_t u16Ratio = (uint16_t)(((uint32_t)y << 16) / x);
+    uint16_t u16Idx = (uint16_t)(u16Ratio >> 8);
+    uint16_t u16Frac = (uint16_t)(u16Ratio & 0xFFu);
+    uint16_t u16Delta = (uint16_t)(l_au16AtanLut[u16Idx + 1u] - l_au16AtanLut[u16Idx]);
+
+    return (uint16_t)((l_au16AtanLut[u16Idx] + (((u16Frac * u16Delta) >> 8) & 0xFFu)) >> 2);
+}
+
+/** atan2_lookup: atan(y/x) for the first quadrant [2pi/65536] */
+static uint16_t host_Atan2Lookup(uint16_t y, uint16_t x)
+{
+    uint16_t u16Result;
+
+    if (y > x)
+    {
+        u16Result = (uint16_t)(0x4000u - host_Atan2Helper(x, y));
+    }
+    else if (x == 0u)
+    {
+        u16Result = 0u;
+    }
+    else if (y == x)
+    {
+        u16Result = 0x2000u;
+    }
+    else
+    {
+        u16Result = host_Atan2Helper(y, x);
+    }
+    return u16Result;
+}
+
+/* ---------------------------------------------
+ * Public Functions Implementation
+ * --------------------------------------------- */
+
+int32_t mulI24_I16byI8(int16_t multiplicand, int8_t multiplier)
+{
+    return (int32_t)multiplicand * multiplier;
+}
+
+int32_t mulI24_I16byU8(int16_t multiplicand, uint8_t multiplier)
+{
+    return (int32_t)multiplicand * multiplier;
+}
+
+uint32_t mulU24_U16byU8(uint16_t multiplicand, uint8_t multiplier)
+{
+    return (uint32_t)multiplicand * multiplier;
+}
+
+uint32_t mulU32_U16byU16(uint16_t multiplicand, uint16_t multiplier)
+{
+    return (uint32_t)multiplicand * multiplier;
+}
+
+int32_t mulI32_I16byI16(int16_t multiplicand, int16_t multiplier)
+{
+    return (int32_t)multiplicand * multiplier;
+}
+
+uint16_t divU16_U32byU16(uint32_t dividend, uint16_t divisor)
+{
+    return (uint16_t)(dividend / divisor);
+}
+
+/** atan2 as 16-bit signed fraction of 2pi, LUT with linear interpolation */
+int16_t atan2I16(int16_t y, int16_t x)
+{
+    uint16_t u16Angle;
+
+    if (l_bAtanLutInit == false)
+    {
+        host_AtanLutInit();
+    }
+    if (y < 0)
+    {
+        if (x < 0)
+        {
+            u16Angle = (uint16_t)(host_Atan2Lookup((uint16_t)-y, (uint16_t)-x) + 0x8000u);
+        }
+        else
+        {
+            u16Angle = (uint16_t)-host_Atan2Lookup((uint16_t)-y, (uint16_t)x);
+        }
+    }
+    else if (x < 0)
+    {
+        u16Angle = (uint16_t)(0x8000u - host_Atan2Lookup((uint16_t)y, (uint16_t)-x));
+    }
+    else
+    {
+        u16Angle = host_Atan2Lookup((uint16_t)y, (uint16_t)x);
+    }
+    return (int16_t)u16Angle;
+}
+
+/** Vector magnitude sqrt(x^2 + y^2), exact, the libmath.a version is an approximation within 4% */
+uint16_t calculate_vector_magnitude(int16_t x, int16_t y)
+{
+    return (uint16_t)lround(hypot((double)x, (double)y));
+}
+
+/* EOF */
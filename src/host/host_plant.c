@@ -0,0 +1,322 @@
+/**
+ * @file
+ * @brief Host build DC motor, gearbox and valve plant model
+ * @internal
+ *
+ * @copyright (C) 2025 Melexis N.V.
+ *
+ * Melexis N.V. is supplying this code for use with Melexis N.V. processor based microcontrollers only.
+ *
+ * THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED OR STATUTORY,
+ * INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.  MELEXIS N.V. SHALL NOT IN ANY CIRCUMSTANCES,
+ * BE LIABLE FOR SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON WHATSOEVER.
+ *
+ * @endinternal
+ *
+ * @ingroup host
+ *
+ * @details The pwm outputs are modelled by their average: in C_HOST_PWM_RUN the armature sees
+ *          duty x supply, in C_HOST_PWM_STOP both terminals are low (dynamic brake) and in
+ *          C_HOST_PWM_OFF the bridge is open, any remaining current freewheels through the
+ *          body diodes into the supply. The model is integrated with explicit Euler steps of
+ *          CT_PERIODIC_RATE / C_HOST_PLANT_SUBSTEPS, well below the electrical time constant.
+ *
+ *          The default parameters describe a 12V valve actuator of about 100deg/s with a
+ *          stall current of 1.2A, which is within the stall (650..1000mA) and below the
+ *          over-current (1500mA) thresholds of the motor driver.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <math.h>
+#include <string.h>
+#include <swtimer_config.h>
+
+#include "defines.h"
+#include "host_hw.h"
+#include "host_plant.h"
+
+/* ---------------------------------------------
+ * Local Defines
+ * --------------------------------------------- */
+
+/** integration step [s] */
+#define C_HOST_PLANT_DT         ((double)CT_PERIODIC_RATE * 1e-6 / (double)C_HOST_PLANT_SUBSTEPS)
+/** body diode forward voltage [V] */
+#define C_HOST_PLANT_V_DIODE    0.7
+/** speed below which the rotor is considered standing still [rad/s] */
+#define C_HOST_PLANT_W_STILL    1e-3
+/** radians to degrees */
+#define C_HOST_PLANT_RAD2DEG    (180.0 / M_PI)
+
+/* ---------------------------------------------
+ * Public Variables
+ * --------------------------------------------- */
+
+/** plant parameters, may be changed before host_plant_Init() */
+HostPlantParam_t g_sHostPlantParam =
+{
+    .dResistance = 10.0,
+    .dResistanceTc = 0.0039,
+    .dInductance = 2.0e-3,
+    .dKe = 0.01,
+    .dInertia = 2.0e-7,
+    .dViscous = 1.0e-6,
+    .dCoulomb = 2.0e-3,
+    .dBreakaway = 3.0e-3,
+    .dFrictionTc = 0.01,
+    .dGearRatio = 500.0,
+    .dBacklash = 1.0,
+    .dStopLow = (double)C_GMR_TARGET_OFFSET,
+    .dStopHigh = (double)C_GMR_TARGET_OFFSET + 90.0 + (2.0 * (double)C_STOPPER_POS_ANGLE),
+    .dMagnetOffset = 0.0,
+    .dGmrAmplitude = 256.0,
+    .dGmrSinOffset = 0.0,
+    .dGmrCosOffset = 0.0,
+    .dGmrCosGain = 1.0,
+    .dGmrPhase = 0.0,
+    .dGmrHarmonic = 0.0,
+    .dGmrHarmonicPhase = 0.0,
+    .dGmrNoise = 0.5
+};
+
+/** plant state */
+HostPlantState_t g_sHostPlant;
+
+/* ---------------------------------------------
+ * Local Variables
+ * --------------------------------------------- */
+
+static uint32_t l_u32NoiseSeed = 0x12345678u;  /**< GMR noise generator state */
+
+/* ---------------------------------------------
+ * Local Functions
+ * --------------------------------------------- */
+
+/** Approximately normal distributed noise, zero mean and unity variance */
+static double host_plant_Noise(void)
+{
+    double dSum = 0.0;
+
+    for (uint16_t i = 0u; i < 12u; i++)
+    {
+        /* xorshift32 */
+        l_u32NoiseSeed ^= l_u32NoiseSeed << 13;
+        l_u32NoiseSeed ^= l_u32NoiseSeed >> 17;
+        l_u32NoiseSeed ^= l_u32NoiseSeed << 5;
+        dSum += (double)l_u32NoiseSeed / 4294967296.0;
+    }
+    return dSum - 6.0;
+}
+
+/** Factor applied to the friction torques at the present temperature */
+static double host_plant_FrictionScale(void)
+{
+    double dScale = 1.0;
+
+    if (g_sHostPlant.dTemperature < 25.0)
+    {
+        dScale += g_sHostPlantParam.dFrictionTc * (25.0 - g_sHostPlant.dTemperature);
+    }
+    return dScale;
+}
+
+/** Armature voltage applied by the bridge
+ * @param[out]  pdSupplyShare  fraction of the armature current drawn from the supply
+ * @retval  armature terminal voltage [V]
+ */
+static double host_plant_BridgeVoltage(double * pdSupplyShare)
+{
+    double dVoltage = 0.0;
+    double dSign;
+
+#if C_MOT_POLE_POLAR == 0
+    dSign = (g_sHostPwm.u8Dir == (uint8_t)C_DIR_CW) ? 1.0 : -1.0;
+#else
+    dSign = (g_sHostPwm.u8Dir == (uint8_t)C_DIR_CCW) ? 1.0 : -1.0;
+#endif
+    *pdSupplyShare = 0.0;
+    switch (g_sHostPwm.e8Mode)
+    {
+        case C_HOST_PWM_RUN:
+            *pdSupplyShare = dSign * (double)g_sHostPwm.u16Duty / (double)C_PWMOUT_MAX_DUTY;
+            dVoltage = g_sHostPlant.dVoltage * *pdSupplyShare;
+            break;
+        case C_HOST_PWM_OFF:
+            /* freewheeling through the body diodes against the supply */
+            if (g_sHostPlant.dCurrent > 0.0)
+            {
+                dVoltage = -(g_sHostPlant.dVoltage + (2.0 * C_HOST_PLANT_V_DIODE));
+                *pdSupplyShare = -1.0;
+            }
+            else if (g_sHostPlant.dCurrent < 0.0)
+            {
+                dVoltage = g_sHostPlant.dVoltage + (2.0 * C_HOST_PLANT_V_DIODE);
+                *pdSupplyShare = 1.0;
+            }
+            else
+            {
+            }
+            break;
+        default: /* C_HOST_PWM_STOP: both low sides on */
+            break;
+    }
+    return dVoltage;
+}
+
+/** Integrate one step of the electrical and mechanical model */
+static void host_plant_Integrate(void)
+{
+    const HostPlantParam_t * pPar = &g_sHostPlantParam;
+    HostPlantState_t * pSt = &g_sHostPlant;
+    double dSupplyShare;
+    double dVoltage = host_plant_BridgeVoltage(&dSupplyShare);
+    double dResistance = pPar->dResistance * (1.0 + (pPar->dResistanceTc * (pSt->dTemperature - 25.0)));
+    double dFriction = host_plant_FrictionScale();
+
+    /* armature */
+    if ((g_sHostPwm.e8Mode == C_HOST_PWM_OFF) && (pSt->dCurrent == 0.0))
+    {
+        /* open bridge, the back-EMF stays below the supply */
+    }
+    else
+    {
+        double dCurrent = pSt->dCurrent +
+                          (((dVoltage - (dResistance * pSt->dCurrent) - (pPar->dKe * pSt->dSpeed)) / pPar->dInductance) *
+                           C_HOST_PLANT_DT);
+        if ((g_sHostPwm.e8Mode == C_HOST_PWM_OFF) && ((dCurrent * pSt->dCurrent) <= 0.0))
+        {
+            dCurrent = 0.0; /* freewheel current extinguished */
+        }
+        pSt->dCurrent = dCurrent;
+    }
+    pSt->dEnergy += g_sHostPlant.dVoltage * dSupplyShare * pSt->dCurrent * C_HOST_PLANT_DT;
+    if (fabs(pSt->dCurrent) > pSt->dPeakCurrent)
+    {
+        pSt->dPeakCurrent = fabs(pSt->dCurrent);
+    }
+
+    /* rotor */
+    double dTorque = pPar->dKe * pSt->dCurrent;
+    if ((fabs(pSt->dSpeed) < C_HOST_PLANT_W_STILL) && (fabs(dTorque) <= (pPar->dBreakaway * dFriction)))
+    {
+        pSt->dSpeed = 0.0; /* sticking */
+    }
+    else
+    {
+        double dDir = (fabs(pSt->dSpeed) >= C_HOST_PLANT_W_STILL) ? copysign(1.0, pSt->dSpeed) : copysign(1.0, dTorque);
+        double dSpeed = pSt->dSpeed +
+                        (((dTorque - (dDir * pPar->dCoulomb * dFriction) - (pPar->dViscous * pSt->dSpeed)) / pPar->dInertia) *
+                         C_HOST_PLANT_DT);
+        if ((dSpeed * dDir) < 0.0)
+        {
+            dSpeed = 0.0; /* friction does not reverse the rotor */
+        }
+        pSt->dSpeed = dSpeed;
+    }
+
+    /* gearbox with backlash: the valve shaft follows once the play is taken up */
+    double dHalfPlay = 0.5 * pPar->dBacklash;
+    pSt->dGearAngle += (pSt->dSpeed * C_HOST_PLANT_DT * C_HOST_PLANT_RAD2DEG) / pPar->dGearRatio;
+    if (pSt->dGearAngle > (pSt->dValveAngle + dHalfPlay))
+    {
+        pSt->dValveAngle = pSt->dGearAngle - dHalfPlay;
+    }
+    else if (pSt->dGearAngle < (pSt->dValveAngle - dHalfPlay))
+    {
+        pSt->dValveAngle = pSt->dGearAngle + dHalfPlay;
+    }
+    else
+    {
+    }
+
+    /* end stops, fully inelastic */
+    pSt->bAtStop = false;
+    if (pSt->dValveAngle >= pPar->dStopHigh)
+    {
+        pSt->dValveAngle = pPar->dStopHigh;
+        pSt->bAtStop = true;
+        if (pSt->dGearAngle >= (pPar->dStopHigh + dHalfPlay))
+        {
+            pSt->dGearAngle = pPar->dStopHigh + dHalfPlay;
+            if (pSt->dSpeed > 0.0)
+            {
+                pSt->dSpeed = 0.0;
+            }
+        }
+    }
+    else if (pSt->dValveAngle <= pPar->dStopLow)
+    {
+        pSt->dValveAngle = pPar->dStopLow;
+        pSt->bAtStop = true;
+        if (pSt->dGearAngle <= (pPar->dStopLow - dHalfPlay))
+        {
+            pSt->dGearAngle = pPar->dStopLow - dHalfPlay;
+            if (pSt->dSpeed < 0.0)
+            {
+                pSt->dSpeed = 0.0;
+            }
+        }
+    }
+    else
+    {
+    }
+}
+
+/** Update the adc samples from the plant state */
+static void host_plant_UpdateAdc(void)
+{
+    const HostPlantParam_t * pPar = &g_sHostPlantParam;
+    double dPhi = (g_sHostPlant.dValveAngle - (double)DEFAULT_GMR_OFFSET + pPar->dMagnetOffset) / C_HOST_PLANT_RAD2DEG;
+
+    /* field angle error of the magnet and bridge geometry */
+    dPhi += (pPar->dGmrHarmonic / C_HOST_PLANT_RAD2DEG) * sin((4.0 * dPhi) + (pPar->dGmrHarmonicPhase / C_HOST_PLANT_RAD2DEG));
+
+    host_adc_SetMotorCurrent((uint16_t)lround(fabs(g_sHostPlant.dCurrent) * 1000.0));
+
+    /* the application reads the angle as atan2(cosine output, sine output) */
+    host_adc_SetGmr((int16_t)lround((pPar->dGmrAmplitude * cos(dPhi)) + pPar->dGmrSinOffset + (pPar->dGmrNoise * host_plant_Noise())),
+                    (int16_t)lround((pPar->dGmrAmplitude * pPar->dGmrCosGain * sin(dPhi + (pPar->dGmrPhase / C_HOST_PLANT_RAD2DEG))) +
+                                    pPar->dGmrCosOffset + (pPar->dGmrNoise * host_plant_Noise())));
+}
+
+/* ---------------------------------------------
+ * Public Functions Implementation
+ * --------------------------------------------- */
+
+/** Reset the plant to standstill, no current, at the given valve angle
+ * @param[in]  dValveAngle  valve shaft angle [deg]
+ */
+void host_plant_Init(double dValveAngle)
+{
+    (void)memset(&g_sHostPlant, 0, sizeof(g_sHostPlant));
+    g_sHostPlant.dValveAngle = dValveAngle;
+    g_sHostPlant.dGearAngle = dValveAngle;
+    host_plant_SetConditions(1200u, 25);
+    host_plant_UpdateAdc();
+}
+
+/** Set the supply voltage and the temperature of plant and chip
+ * @param[in]  u16Voltage      supply voltage [10mV]
+ * @param[in]  i16Temperature  temperature [C]
+ */
+void host_plant_SetConditions(uint16_t u16Voltage, int16_t i16Temperature)
+{
+    g_sHostPlant.dVoltage = (double)u16Voltage * 0.01;
+    g_sHostPlant.dTemperature = (double)i16Temperature;
+    host_adc_SetSupplyVoltage(u16Voltage);
+    host_adc_SetChipTemperature(i16Temperature);
+}
+
+/** Advance the plant by one core timer period and update the adc samples */
+void host_plant_Step(void)
+{
+    for (uint16_t i = 0u; i < C_HOST_PLANT_SUBSTEPS; i++)
+    {
+        host_plant_Integrate();
+    }
+    host_plant_UpdateAdc();
+}
+
+/* EOF */
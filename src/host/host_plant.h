@@ -0,0 +1,109 @@
+/**
+ * @file
+ * @brief Host build DC motor, gearbox and valve plant model
+ * @internal
+ *
+ * @copyright (C) 2025 Melexis N.V.
+ *
+ * Melexis N.V. is supplying this code for use with Melexis N.V. processor based microcontrollers only.
+ *
+ * THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED OR STATUTORY,
+ * INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.  MELEXIS N.V. SHALL NOT IN ANY CIRCUMSTANCES,
+ * BE LIABLE FOR SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON WHATSOEVER.
+ *
+ * @endinternal
+ *
+ * @ingroup host
+ *
+ * @details Closes the loop around the application in the host build. The model reads the
+ *          bridge state the application requested through the pwm driver (g_sHostPwm) and
+ *          feeds the motor current and the GMR bridge outputs back into the adc samples.
+ *
+ *          - armature: R (copper temperature coefficient), L and back-EMF
+ *          - rotor: inertia, viscous, Coulomb and breakaway friction (increasing when cold)
+ *          - gearbox: ratio and output backlash
+ *          - valve: mechanical end stops
+ *          - GMR: sin/cos bridge on the valve shaft with magnet offset, output offsets,
+ *            amplitude mismatch, quadrature error and noise
+ *
+ *          Angles of the plant are output shaft angles in degrees, in the frame the
+ *          application reads with the default GMR sensor offset (DEFAULT_GMR_OFFSET).
+ */
+
+#ifndef HOST_PLANT_H_
+#define HOST_PLANT_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/* ---------------------------------------------
+ * Public Defines
+ * --------------------------------------------- */
+
+/** integration steps per core timer period */
+#define C_HOST_PLANT_SUBSTEPS   10u
+
+/* ---------------------------------------------
+ * Public Types
+ * --------------------------------------------- */
+
+/** plant parameters */
+typedef struct
+{
+    double dResistance;     /**< armature resistance at 25C [Ohm] */
+    double dResistanceTc;   /**< armature resistance temperature coefficient [1/K] */
+    double dInductance;     /**< armature inductance [H] */
+    double dKe;             /**< back-EMF and torque constant [V.s/rad] = [N.m/A] */
+    double dInertia;        /**< rotor and gearbox inertia at the motor shaft [kg.m2] */
+    double dViscous;        /**< viscous friction at the motor shaft [N.m.s/rad] */
+    double dCoulomb;        /**< Coulomb friction at the motor shaft, 25C [N.m] */
+    double dBreakaway;      /**< breakaway (static) friction at the motor shaft, 25C [N.m] */
+    double dFrictionTc;     /**< friction increase per K below 25C [1/K] */
+    double dGearRatio;      /**< motor revolutions per output revolution */
+    double dBacklash;       /**< gearbox output backlash [deg] */
+    double dStopLow;        /**< lower mechanical end stop [deg] */
+    double dStopHigh;       /**< upper mechanical end stop [deg] */
+    double dMagnetOffset;   /**< GMR magnet offset w.r.t. the nominal mounting [deg] */
+    double dGmrAmplitude;   /**< differential GMR sin/cos amplitude [LSB] */
+    double dGmrSinOffset;   /**< offset of the output read as sine output [LSB] */
+    double dGmrCosOffset;   /**< offset of the output read as cosine output [LSB] */
+    double dGmrCosGain;     /**< cosine output amplitude w.r.t. the sine output */
+    double dGmrPhase;       /**< quadrature error of the cosine output [deg] */
+    double dGmrHarmonic;    /**< 4th harmonic angle error amplitude [deg] */
+    double dGmrHarmonicPhase; /**< 4th harmonic angle error phase [deg] */
+    double dGmrNoise;       /**< GMR output noise [LSB rms] */
+} HostPlantParam_t;
+
+/** plant state */
+typedef struct
+{
+    double dVoltage;        /**< supply voltage [V] */
+    double dTemperature;    /**< ambient (motor and gearbox) temperature [C] */
+    double dCurrent;        /**< armature current, positive drives the angle up [A] */
+    double dSpeed;          /**< motor speed [rad/s] */
+    double dGearAngle;      /**< gearbox output angle before the backlash [deg] */
+    double dValveAngle;     /**< valve shaft angle [deg] */
+    double dEnergy;         /**< energy taken from the supply [J] */
+    double dPeakCurrent;    /**< peak armature current magnitude [A] */
+    bool bAtStop;           /**< valve rests against an end stop */
+} HostPlantState_t;
+
+/* ---------------------------------------------
+ * Public Variables
+ * --------------------------------------------- */
+
+extern HostPlantParam_t g_sHostPlantParam;
+extern HostPlantState_t g_sHostPlant;
+
+/* ---------------------------------------------
+ * Public Function Declarations
+ * --------------------------------------------- */
+
+void host_plant_Init(double dValveAngle);
+void host_plant_SetConditions(uint16_t u16Voltage, int16_t i16Temperature);
+void host_plant_Step(void);
+
+#endif /* HOST_PLANT_H_ */
+
+/* EOF */
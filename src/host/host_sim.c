@@ -0,0 +1,809 @@
+/**
+ * @file
+ * @brief Host build closed-loop valve simulation
+ * @internal
+ *
+ * @copyright (C) 2025 Melexis N.V.
+ *
+ * Melexis N.V. is supplying this code for use with Melexis N.V. processor based microcontrollers only.
+ *
+ * THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED OR STATUTORY,
+ * INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.  MELEXIS N.V. SHALL NOT IN ANY CIRCUMSTANCES,
+ * BE LIABLE FOR SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON WHATSOEVER.
+ *
+ * @endinternal
+ *
+ * @ingroup host
+ *
+ * @details Runs the application against the plant model of host_plant.c, with a LIN master
+ *          sending VPC_Fwv_Ctrl every C_SIM_LIN_PERIOD_MS. For every supply voltage (one per
+ *          voltage bucket of app_motor_task()) and temperature of the sweep:
+ *          - moves: Mode B -> A -> B, reporting move time, overshoot, final error, energy
+ *            taken from the supply and peak current;
+ *          - drift: the output pushed off mode B in standby, as by the flow torque, reporting
+ *            the time until the position hold corrected it;
+ *          - leg fault: a GMR bridge leg stuck at a level during a B > A move, as by an open
+ *            or shorted leg, reporting the time until the motor stood and the travel after it;
+ *          - calibration: end stops and GMR magnet displaced by the given tolerances, GMR
+ *            output errors and a 4th harmonic angle error (-e, -a), the full calibration is
+ *            timed from power-up until ValveCalibrationTask() finishes, followed by the
+ *            resulting Mode B and Mode A errors w.r.t. the end stops. Two ignition off cycles
+ *            follow, parked in Mode A and in Mode B, each timing the quick calibration from
+ *            the ignition off and reporting the same errors. A power cycle with the valve
+ *            turned C_SIM_BOOT_DRIFT closes the run, no calibration time is reported when the
+ *            stored calibration was accepted. Last, the GMR output offsets drift by
+ *            C_SIM_GMR_DRIFT and after C_SIM_GMR_MOVES move pairs without a calibration the
+ *            Mode B and Mode A errors are reported again. A row fails unless the valve ends
+ *            in standby with both errors within C_VALVE_ACCURACY_ANGLE.
+ *          Every operating point runs in its own process, starting from a freshly
+ *          initialized application and an erased EEPROM. The motor driver runs in its build
+ *          default controller mode unless -r, -p or -j select another one.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <unistd.h>
+#include <sys/wait.h>
+#include <swtimer.h>
+#include <swtimer_config.h>
+
+#include "defines.h"
+#include "system.h"
+#include "fw_ints.h"
+#include "AppValve.h"
+#include "app_sensor.h"
+#include "dcm_driver.h"
+#include "host_hw.h"
+#include "host_eeprom.h"
+#include "host_plant.h"
+
+/* ---------------------------------------------
+ * Local Defines
+ * --------------------------------------------- */
+
+/** number of ticks per millisecond */
+#define C_SIM_TICKS_PER_MS      (1000u / CT_PERIODIC_RATE)
+/** LIN master frame period [ms] */
+#define C_SIM_LIN_PERIOD_MS     10u
+/** time from power-up until the application is expected in standby [ms] */
+#define C_SIM_BOOT_MS           200u
+/** maximum time of a single move [ms] */
+#define C_SIM_MOVE_TIMEOUT_MS   6000u
+/** time the valve is observed after the motor stopped [ms] */
+#define C_SIM_SETTLE_MS         500u
+/** maximum time of the calibration [ms] */
+#define C_SIM_CAL_TIMEOUT_MS    30000u
+/** maximum time from the ignition off until the quick calibration finished [ms] */
+#define C_SIM_QUICKCAL_TIMEOUT_MS 90000u
+/** valve turn while unpowered before the power cycle of the calibration run [deg] */
+#define C_SIM_BOOT_DRIFT        3.0
+/** valve angle at power-up for the calibration run [deg] */
+#define C_SIM_CAL_START_ANGLE   240.0
+/** GMR output offset drift after the calibration run, as by temperature [LSB] */
+#define C_SIM_GMR_DRIFT         8.0
+/** B > A > B move pairs with the drifted GMR outputs */
+#define C_SIM_GMR_MOVES         3u
+/** time the angle is read after the valve was set [ms] */
+#define C_SIM_ANGLE_MS          2u
+/** time from the mode A command to the GMR leg fault [ms] */
+#define C_SIM_LEG_FAULT_MS      200u
+
+/* ---------------------------------------------
+ * Local Types
+ * --------------------------------------------- */
+
+/** result of a single move */
+typedef struct
+{
+    double dTime;           /**< command to motor stopped [ms] */
+    double dOvershoot;      /**< maximum excursion beyond the target [deg] */
+    double dError;          /**< valve angle minus target after settling [deg] */
+    double dEnergy;         /**< energy taken from the supply [mJ] */
+    double dPeakCurrent;    /**< peak armature current [mA] */
+    tValveState eState;     /**< valve state after settling */
+} HostSimMove_t;
+
+/* ---------------------------------------------
+ * Local Variables
+ * --------------------------------------------- */
+
+static uint32_t l_u32Tick;              /**< ticks since power-up */
+static uint8_t l_u8TargetMode;          /**< target mode sent by the LIN master */
+static double l_dStopOffset = 2.0;      /**< end stop displacement of the calibration run [deg] */
+static double l_dMagnetOffset = 3.0;    /**< magnet displacement of the calibration run [deg] */
+static double l_adGmrError[4] = {4.0, -3.0, 1.03, 2.0}; /**< GMR sin, cos offset [LSB], cos gain, phase [deg] of the calibration run */
+static double l_adGmrHarmonic[2] = {0.5, 30.0}; /**< GMR 4th harmonic angle error amplitude, phase [deg] of the calibration run */
+static double l_adMotorScale[2] = {1.0, 1.0}; /**< plant winding resistance and back-EMF constant w.r.t. the firmware model */
+/** motor factors of the -K calibration runs, nominal and the +/-20% corners */
+static const double l_aadMotorCorner[][2] = {{1.0, 1.0}, {0.8, 0.8}, {0.8, 1.2}, {1.2, 0.8}, {1.2, 1.2}};
+static uint8_t l_u8CtrlMode = C_MOT_CTRL_MODE; /**< motor controller mode */
+static uint16_t l_au16PidGains[3] = {C_PID_KP, C_PID_KI, C_PID_KD}; /**< PID gains [Q8] */
+static uint16_t l_u16MovePairs = 1u;    /**< number of B > A > B move pairs */
+static uint32_t l_u32ReverseMs = 0u;    /**< mode B commanded this long into a B > A move, 0: off */
+static double l_dDrift = 0.0;           /**< output pushed off mode B after the moves [deg], 0: off */
+static uint16_t l_au16LegFault[2] = {0u, 0u}; /**< GMR IO 1..4 and its forced level [LSB] during a last B>A move, 0: off */
+
+static const uint16_t l_au16Voltage[] = {900u, 1000u, 1100u, 1200u, 1350u, 1500u};
+static const int16_t l_ai16Temperature[] = {-40, 25, 85};
+static const char * const l_apCtrlMode[] = {"", "duty ramp", "PID position loop", "S-curve trajectory"};
+
+/* ---------------------------------------------
+ * Local Functions
+ * --------------------------------------------- */
+
+/** Simulate one core timer period */
+static void host_sim_Tick(void)
+{
+    host_plant_Step();
+    if ((l_u32Tick % (C_SIM_LIN_PERIOD_MS * C_SIM_TICKS_PER_MS)) == 0u)
+    {
+        host_lin_SendCtrl(l_u8TargetMode, true, false);
+    }
+    _STIMER_INT();
+    main_Task();
+    l_u32Tick++;
+}
+
+/** Simulate a number of milliseconds */
+static void host_sim_Run(uint32_t u32TimeMs)
+{
+    for (uint32_t i = 0u; i < (u32TimeMs * C_SIM_TICKS_PER_MS); i++)
+    {
+        host_sim_Tick();
+    }
+}
+
+/** Valve angle corresponding to an application position
+ * @param[in]  i16Position  application position [0.1deg]
+ * @retval  valve shaft angle [deg]
+ */
+static double host_sim_ValveAngle(int16_t i16Position)
+{
+    return ((double)(i16Position - get_gmr_sensor_offset()) / (double)C_GMR_ANGLE_SCALE_FACTOR) +
+           (double)DEFAULT_GMR_OFFSET - g_sHostPlantParam.dMagnetOffset;
+}
+
+/** Power-up the application, the EEPROM keeps its content
+ * @param[in]  u16Voltage      supply voltage [10mV]
+ * @param[in]  i16Temperature  temperature [C]
+ * @param[in]  dValveAngle     valve angle [deg]
+ */
+static void host_sim_Boot(uint16_t u16Voltage, int16_t i16Temperature, double dValveAngle)
+{
+    host_hw_Init();
+    host_plant_Init(dValveAngle);
+    host_plant_SetConditions(u16Voltage, i16Temperature);
+    l_u32Tick = 0u;
+    l_u8TargetMode = C_MODE_B;
+    main_Init();
+    MotSetCtrlMode(l_u8CtrlMode);
+    MotSetPidGains(l_au16PidGains[0], l_au16PidGains[1], l_au16PidGains[2]);
+}
+
+/** Power-up the application with an erased EEPROM, see host_sim_Boot() */
+static void host_sim_PowerUp(uint16_t u16Voltage, int16_t i16Temperature, double dValveAngle)
+{
+    host_eeprom_Erase();
+    host_sim_Boot(u16Voltage, i16Temperature, dValveAngle);
+}
+
+/** Command a mode and observe the move until the valve settled
+ * @param[in]   u8Mode  C_MODE_A or C_MODE_B
+ * @param[out]  pRes    move result
+ */
+static void host_sim_Move(uint8_t u8Mode, HostSimMove_t * pRes)
+{
+    uint32_t u32Start = l_u32Tick;
+    uint32_t u32End = 0u;
+    double dEnergy = g_sHostPlant.dEnergy;
+    double dStart = g_sHostPlant.dValveAngle;
+    double dOvershoot = 0.0;
+    double dTarget;
+    double dDir;
+    bool bMoving = false;
+
+    g_sHostPlant.dPeakCurrent = 0.0;
+    l_u8TargetMode = u8Mode;
+    while ((l_u32Tick - u32Start) < ((C_SIM_MOVE_TIMEOUT_MS + C_SIM_SETTLE_MS) * C_SIM_TICKS_PER_MS))
+    {
+        host_sim_Tick();
+
+        tMotState eMot = MotGetState();
+        if ((eMot >= MOTION_ACC) && (eMot <= MOTION_FINE))
+        {
+            bMoving = true;
+        }
+        else if (bMoving && (u32End == 0u))
+        {
+            u32End = l_u32Tick;
+        }
+        else
+        {
+        }
+        if (bMoving)
+        {
+            dTarget = host_sim_ValveAngle(MotGetTargetPosition());
+            dDir = (dTarget >= dStart) ? 1.0 : -1.0;
+            if ((dDir * (g_sHostPlant.dValveAngle - dTarget)) > dOvershoot)
+            {
+                dOvershoot = dDir * (g_sHostPlant.dValveAngle - dTarget);
+            }
+        }
+        if ((u32End != 0u) && ((l_u32Tick - u32End) >= (C_SIM_SETTLE_MS * C_SIM_TICKS_PER_MS)))
+        {
+            break;
+        }
+    }
+
+    dTarget = host_sim_ValveAngle(MotGetTargetPosition());
+    pRes->dTime = (u32End != 0u) ? ((double)(u32End - u32Start) / (double)C_SIM_TICKS_PER_MS) : NAN;
+    pRes->dOvershoot = dOvershoot;
+    pRes->dError = g_sHostPlant.dValveAngle - dTarget;
+    pRes->dEnergy = (g_sHostPlant.dEnergy - dEnergy) * 1000.0;
+    pRes->dPeakCurrent = g_sHostPlant.dPeakCurrent * 1000.0;
+    pRes->eState = get_valve_mode();
+}
+
+/** Command mode B during a B > A move and observe until the valve is back in B
+ * @param[in]   u32DelayMs  time from the mode A to the mode B command [ms]
+ * @param[out]  pRes        move result, the time counts from the mode B command
+ */
+static void host_sim_Reverse(uint32_t u32DelayMs, HostSimMove_t * pRes)
+{
+    double dTarget = g_sHostPlant.dValveAngle;
+    double dOvershoot = 0.0;
+    double dEnergy;
+    double dDir;
+    uint32_t u32Start;
+    uint32_t u32End = 0u;
+
+    l_u8TargetMode = C_MODE_A;
+    host_sim_Run(u32DelayMs);
+    u32Start = l_u32Tick;
+    dEnergy = g_sHostPlant.dEnergy;
+    dDir = (dTarget >= g_sHostPlant.dValveAngle) ? 1.0 : -1.0;
+    g_sHostPlant.dPeakCurrent = 0.0;
+    l_u8TargetMode = C_MODE_B;
+    while ((l_u32Tick - u32Start) < ((C_SIM_MOVE_TIMEOUT_MS + C_SIM_SETTLE_MS) * C_SIM_TICKS_PER_MS))
+    {
+        host_sim_Tick();
+
+        tMotState eMot = MotGetState();
+        if ((dDir * (g_sHostPlant.dValveAngle - dTarget)) > dOvershoot)
+        {
+            dOvershoot = dDir * (g_sHostPlant.dValveAngle - dTarget);
+        }
+        if ((u32End == 0u) && ((eMot < MOTION_ACC) || (eMot > MOTION_FINE)) && (fabs(g_sHostPlant.dValveAngle - dTarget) < 1.0))
+        {
+            u32End = l_u32Tick;
+        }
+        if ((u32End != 0u) && ((l_u32Tick - u32End) >= (C_SIM_SETTLE_MS * C_SIM_TICKS_PER_MS)))
+        {
+            break;
+        }
+    }
+
+    pRes->dTime = (u32End != 0u) ? ((double)(u32End - u32Start) / (double)C_SIM_TICKS_PER_MS) : NAN;
+    pRes->dOvershoot = dOvershoot;
+    pRes->dError = g_sHostPlant.dValveAngle - dTarget;
+    pRes->dEnergy = (g_sHostPlant.dEnergy - dEnergy) * 1000.0;
+    pRes->dPeakCurrent = g_sHostPlant.dPeakCurrent * 1000.0;
+    pRes->eState = get_valve_mode();
+}
+
+/** Push the output off the target in standby and observe the position hold
+ * @param[in]   dDrift  push [deg]
+ * @param[out]  pRes    move result, the time counts from the push until the motor stood again
+ */
+static void host_sim_Drift(double dDrift, HostSimMove_t * pRes)
+{
+    double dTarget = host_sim_ValveAngle(MotGetTargetPosition());
+    double dOvershoot = 0.0;
+    double dEnergy = g_sHostPlant.dEnergy;
+    double dDir = (dDrift >= 0.0) ? -1.0 : 1.0;
+    uint32_t u32Start = l_u32Tick;
+    uint32_t u32End = 0u;
+    bool bMoving = false;
+
+    g_sHostPlant.dPeakCurrent = 0.0;
+    g_sHostPlant.dGearAngle += dDrift;
+    g_sHostPlant.dValveAngle += dDrift;
+    while ((l_u32Tick - u32Start) < ((C_SIM_MOVE_TIMEOUT_MS + C_SIM_SETTLE_MS) * C_SIM_TICKS_PER_MS))
+    {
+        host_sim_Tick();
+
+        tMotState eMot = MotGetState();
+        if ((eMot >= MOTION_ACC) && (eMot <= MOTION_FINE))
+        {
+            bMoving = true;
+        }
+        else if (bMoving && (u32End == 0u))
+        {
+            u32End = l_u32Tick;
+        }
+        else
+        {
+        }
+        if ((dDir * (g_sHostPlant.dValveAngle - dTarget)) > dOvershoot)
+        {
+            dOvershoot = dDir * (g_sHostPlant.dValveAngle - dTarget);
+        }
+        if ((u32End != 0u) && ((l_u32Tick - u32End) >= (C_SIM_SETTLE_MS * C_SIM_TICKS_PER_MS)))
+        {
+            break;
+        }
+    }
+
+    pRes->dTime = (u32End != 0u) ? ((double)(u32End - u32Start) / (double)C_SIM_TICKS_PER_MS) : NAN;
+    pRes->dOvershoot = dOvershoot;
+    pRes->dError = g_sHostPlant.dValveAngle - dTarget;
+    pRes->dEnergy = (g_sHostPlant.dEnergy - dEnergy) * 1000.0;
+    pRes->dPeakCurrent = g_sHostPlant.dPeakCurrent * 1000.0;
+    pRes->eState = get_valve_mode();
+}
+
+/** Force a GMR bridge leg to a level during a B > A move and observe until the motor stood
+ * @param[out]  pRes  move result, the time counts from the leg fault, the overshoot is the
+ *                    largest and the error the final valve travel after it
+ */
+static void host_sim_LegFault(HostSimMove_t * pRes)
+{
+    double dStart;
+    double dEnergy;
+    double dTravel = 0.0;
+    uint32_t u32Start;
+    uint32_t u32End = 0u;
+
+    l_u8TargetMode = C_MODE_A;
+    host_sim_Run(C_SIM_LEG_FAULT_MS);
+    u32Start = l_u32Tick;
+    dStart = g_sHostPlant.dValveAngle;
+    dEnergy = g_sHostPlant.dEnergy;
+    g_sHostPlant.dPeakCurrent = 0.0;
+    host_adc_SetGmrLegFault((uint8_t)l_au16LegFault[0], l_au16LegFault[1]);
+    while ((l_u32Tick - u32Start) < ((C_SIM_MOVE_TIMEOUT_MS + C_SIM_SETTLE_MS) * C_SIM_TICKS_PER_MS))
+    {
+        host_sim_Tick();
+
+        tMotState eMot = MotGetState();
+        if (fabs(g_sHostPlant.dValveAngle - dStart) > dTravel)
+        {
+            dTravel = fabs(g_sHostPlant.dValveAngle - dStart);
+        }
+        if ((u32End == 0u) && ((eMot < MOTION_ACC) || (eMot > MOTION_FINE)))
+        {
+            u32End = l_u32Tick;
+        }
+        if ((u32End != 0u) && ((l_u32Tick - u32End) >= (C_SIM_SETTLE_MS * C_SIM_TICKS_PER_MS)))
+        {
+            break;
+        }
+    }
+
+    pRes->dTime = (u32End != 0u) ? ((double)(u32End - u32Start) / (double)C_SIM_TICKS_PER_MS) : NAN;
+    pRes->dOvershoot = dTravel;
+    pRes->dError = g_sHostPlant.dValveAngle - dStart;
+    pRes->dEnergy = (g_sHostPlant.dEnergy - dEnergy) * 1000.0;
+    pRes->dPeakCurrent = g_sHostPlant.dPeakCurrent * 1000.0;
+    pRes->eState = get_valve_mode();
+    host_adc_SetGmrLegFault(0u, 0u);
+}
+
+static void host_sim_PrintMove(const char * pName, uint16_t u16Voltage, int16_t i16Temperature, const HostSimMove_t * pRes)
+{
+    printf("%6.2f %5d  %-4s %9.1f %14.2f %8.2f %10.1f %8.0f %5u\n",
+           (double)u16Voltage * 0.01, i16Temperature, pName, pRes->dTime, pRes->dOvershoot,
+           pRes->dError, pRes->dEnergy, pRes->dPeakCurrent, (unsigned)pRes->eState);
+}
+
+/** Mode B -> A -> B moves at one operating point, repeated to show what the controller learns */
+static void host_sim_Moves(uint16_t u16Voltage, int16_t i16Temperature)
+{
+    HostSimMove_t sRes;
+
+    host_sim_PowerUp(u16Voltage, i16Temperature, ((double)C_VALVE_MODE_B_ANGLE / (double)C_GMR_ANGLE_SCALE_FACTOR));
+    host_sim_Run(C_SIM_BOOT_MS);
+
+    for (uint16_t n = 0u; n < l_u16MovePairs; n++)
+    {
+        host_sim_Move(C_MODE_A, &sRes);
+        host_sim_PrintMove("B>A", u16Voltage, i16Temperature, &sRes);
+        host_sim_Move(C_MODE_B, &sRes);
+        host_sim_PrintMove("A>B", u16Voltage, i16Temperature, &sRes);
+    }
+    if (l_u32ReverseMs != 0u)
+    {
+        host_sim_Reverse(l_u32ReverseMs, &sRes);
+        host_sim_PrintMove("rev", u16Voltage, i16Temperature, &sRes);
+    }
+    else if (l_dDrift != 0.0)
+    {
+        host_sim_Drift(l_dDrift, &sRes);
+        host_sim_PrintMove("drf", u16Voltage, i16Temperature, &sRes);
+    }
+    else if (l_au16LegFault[0] != 0u)
+    {
+        host_sim_LegFault(&sRes);
+        host_sim_PrintMove("leg", u16Voltage, i16Temperature, &sRes);
+    }
+    else
+    {
+    }
+}
+
+/** Result of a calibration row
+ * @param[in]  dErrorB  Mode B error w.r.t. the end stop [deg]
+ * @param[in]  dErrorA  Mode A error w.r.t. the end stop [deg]
+ * @retval  "ok" in standby with both errors within C_VALVE_ACCURACY_ANGLE, "FAIL" otherwise
+ */
+static const char * host_sim_Verdict(double dErrorB, double dErrorA)
+{
+    double dWindow = (double)C_VALVE_ACCURACY_ANGLE / (double)C_GMR_ANGLE_SCALE_FACTOR;
+
+    return ((get_valve_mode() == VALVE_STANDBY) && (fabs(dErrorB) <= dWindow) && (fabs(dErrorA) <= dWindow)) ? "ok" : "FAIL";
+}
+
+/** Run a calibration, settle in Mode B, move to Mode A and print the result
+ * @param[in]  pName       calibration name
+ * @param[in]  u32TimeoutMs  maximum time from now until the calibration finished [ms]
+ */
+static void host_sim_CalibrationRun(const char * pName, uint16_t u16Voltage, int16_t i16Temperature, uint32_t u32TimeoutMs)
+{
+    HostSimMove_t sRes;
+    uint32_t u32Begin = l_u32Tick;
+    uint32_t u32Start = 0u;
+    uint32_t u32End = 0u;
+    double dErrorB;
+    double dErrorA;
+
+    while ((l_u32Tick - u32Begin) < (u32TimeoutMs * C_SIM_TICKS_PER_MS))
+    {
+        host_sim_Tick();
+        if (get_valve_mode() == VALVE_CALIBRATION)
+        {
+            if (u32Start == 0u)
+            {
+                u32Start = l_u32Tick;
+            }
+        }
+        else if (u32Start != 0u)
+        {
+            u32End = l_u32Tick;
+            break;
+        }
+        else
+        {
+        }
+    }
+    /* the calibration parks in Mode B, the hard stop of the ignition off ends with the
+     * debounced ignition on */
+    l_u8TargetMode = C_MODE_B;
+    host_adc_SetIgnition(true);
+    for (uint32_t i = 0u; (i < (C_SIM_MOVE_TIMEOUT_MS * C_SIM_TICKS_PER_MS)) && (get_sys_valve_mode() == VALVE_POWERLATCH); i++)
+    {
+        host_sim_Tick();
+    }
+    host_sim_Run(C_SIM_SETTLE_MS);
+    dErrorB = g_sHostPlant.dValveAngle - (g_sHostPlantParam.dStopLow + (double)C_STOPPER_POS_ANGLE);
+
+    host_sim_Move(C_MODE_A, &sRes);
+    dErrorA = g_sHostPlant.dValveAngle - (g_sHostPlantParam.dStopHigh - (double)C_STOPPER_POS_ANGLE);
+    printf("%6.2f %5d  %-5s %9.1f %8.1f  %-6s %10.2f %10.2f\n",
+           (double)u16Voltage * 0.01, i16Temperature, pName,
+           (u32End != 0u) ? ((double)(u32End - u32Begin) / (double)C_SIM_TICKS_PER_MS) : NAN,
+           (u32End != 0u) ? ((double)(u32End - u32Start) / (double)C_SIM_TICKS_PER_MS) : NAN,
+           host_sim_Verdict(dErrorB, dErrorA), dErrorB, dErrorA);
+}
+
+/** Angle error of the application over the arc between the end stops, the valve is set to
+ * every degree with the motor standing
+ * @param[out]  pMin  smallest error [deg]
+ * @param[out]  pMax  largest error [deg]
+ */
+static void host_sim_AngleError(double * pMin, double * pMax)
+{
+    double dAngle = g_sHostPlant.dValveAngle;
+    double dError;
+
+    *pMin = INFINITY;
+    *pMax = -INFINITY;
+    for (double a = ceil(g_sHostPlantParam.dStopLow); a <= g_sHostPlantParam.dStopHigh; a += 1.0)
+    {
+        g_sHostPlant.dGearAngle = a;
+        g_sHostPlant.dValveAngle = a;
+        host_sim_Run(C_SIM_ANGLE_MS);
+        dError = host_sim_ValveAngle(MotGetCurrentPosition()) - a;
+        *pMin = fmin(*pMin, dError);
+        *pMax = fmax(*pMax, dError);
+    }
+    g_sHostPlant.dGearAngle = dAngle;
+    g_sHostPlant.dValveAngle = dAngle;
+    host_sim_Run(C_SIM_ANGLE_MS);
+}
+
+/** Calibration against displaced end stops and a GMR bridge with output errors at one
+ * operating point, then quick calibrations from both ends, a power cycle and moves after a
+ * drift of the GMR output offsets
+ */
+static void host_sim_Calibration(uint16_t u16Voltage, int16_t i16Temperature)
+{
+    HostSimMove_t sRes;
+    double dErrorB;
+    double dErrorA;
+
+    g_sHostPlantParam.dStopLow += l_dStopOffset;
+    g_sHostPlantParam.dStopHigh += l_dStopOffset;
+    g_sHostPlantParam.dMagnetOffset = l_dMagnetOffset;
+    g_sHostPlantParam.dGmrSinOffset = l_adGmrError[0];
+    g_sHostPlantParam.dGmrCosOffset = l_adGmrError[1];
+    g_sHostPlantParam.dGmrCosGain = l_adGmrError[2];
+    g_sHostPlantParam.dGmrPhase = l_adGmrError[3];
+    g_sHostPlantParam.dGmrHarmonic = l_adGmrHarmonic[0];
+    g_sHostPlantParam.dGmrHarmonicPhase = l_adGmrHarmonic[1];
+    host_sim_PowerUp(u16Voltage, i16Temperature, C_SIM_CAL_START_ANGLE);
+    host_sim_CalibrationRun("full", u16Voltage, i16Temperature, C_SIM_CAL_TIMEOUT_MS);
+    printf("%6.2f %5d  %-5s %9.1f %8.1f  %-6s %10.2f %10.2f\n",
+           (double)u16Voltage * 0.01, i16Temperature, "play", NAN, NAN, "lrn/pl",
+           (double)MotGetBacklash() / (double)C_GMR_ANGLE_SCALE_FACTOR, g_sHostPlantParam.dBacklash);
+
+    /* parked in Mode A */
+    host_adc_SetIgnition(false);
+    host_sim_CalibrationRun("q/A", u16Voltage, i16Temperature, C_SIM_QUICKCAL_TIMEOUT_MS);
+
+    /* parked in Mode B */
+    host_sim_Move(C_MODE_B, &sRes);
+    host_adc_SetIgnition(false);
+    host_sim_CalibrationRun("q/B", u16Voltage, i16Temperature, C_SIM_QUICKCAL_TIMEOUT_MS);
+
+    /* power cycle, the valve turned a little while unpowered */
+    host_sim_Move(C_MODE_B, &sRes);
+    host_sim_Boot(u16Voltage, i16Temperature, g_sHostPlant.dValveAngle + C_SIM_BOOT_DRIFT);
+    host_sim_CalibrationRun("boot", u16Voltage, i16Temperature, C_SIM_CAL_TIMEOUT_MS);
+    host_sim_AngleError(&dErrorB, &dErrorA);
+    printf("%6.2f %5d  %-5s %9.1f %8.1f  %-6s %10.2f %10.2f\n",
+           (double)u16Voltage * 0.01, i16Temperature, "ang", NAN, NAN, "min/max", dErrorB, dErrorA);
+
+    /* GMR output offsets drift, moves without a calibration */
+    g_sHostPlantParam.dGmrSinOffset += C_SIM_GMR_DRIFT;
+    g_sHostPlantParam.dGmrCosOffset -= C_SIM_GMR_DRIFT;
+    for (uint16_t n = 0u; n < C_SIM_GMR_MOVES; n++)
+    {
+        host_sim_Move(C_MODE_A, &sRes);
+        host_sim_Move(C_MODE_B, &sRes);
+    }
+    dErrorB = g_sHostPlant.dValveAngle - (g_sHostPlantParam.dStopLow + (double)C_STOPPER_POS_ANGLE);
+    host_sim_Move(C_MODE_A, &sRes);
+    dErrorA = g_sHostPlant.dValveAngle - (g_sHostPlantParam.dStopHigh - (double)C_STOPPER_POS_ANGLE);
+    printf("%6.2f %5d  %-5s %9.1f %8.1f  %-6s %10.2f %10.2f\n",
+           (double)u16Voltage * 0.01, i16Temperature, "gmr", NAN, NAN,
+           host_sim_Verdict(dErrorB, dErrorA), dErrorB, dErrorA);
+}
+
+/** Run a scenario in a child process so that every run starts from the power-up state */
+static void host_sim_Spawn(void (*pScenario)(uint16_t, int16_t), uint16_t u16Voltage, int16_t i16Temperature)
+{
+    (void)fflush(stdout);
+    pid_t pid = fork();
+
+    if (pid == 0)
+    {
+        pScenario(u16Voltage, i16Temperature);
+        (void)fflush(stdout);
+        _exit(0);
+    }
+    else if (pid > 0)
+    {
+        (void)waitpid(pid, NULL, 0);
+    }
+    else
+    {
+        pScenario(u16Voltage, i16Temperature);
+    }
+}
+
+static void host_sim_Sweep(void (*pScenario)(uint16_t, int16_t), int32_t i32Voltage, int32_t i32Temperature)
+{
+    for (uint16_t v = 0u; v < (sizeof(l_au16Voltage) / sizeof(l_au16Voltage[0])); v++)
+    {
+        for (uint16_t t = 0u; t < (sizeof(l_ai16Temperature) / sizeof(l_ai16Temperature[0])); t++)
+        {
+            uint16_t u16Voltage = (i32Voltage >= 0) ? (uint16_t)i32Voltage : l_au16Voltage[v];
+            int16_t i16Temperature = (i32Temperature > -1000) ? (int16_t)i32Temperature : l_ai16Temperature[t];
+
+            host_sim_Spawn(pScenario, u16Voltage, i16Temperature);
+            if (i32Temperature > -1000)
+            {
+                break;
+            }
+        }
+        if (i32Voltage >= 0)
+        {
+            break;
+        }
+    }
+}
+
+static void host_sim_Usage(const char * pName)
+{
+    printf("Usage: %s [-m | -c] [-v voltage] [-t temperature] [-s stop_offset] [-o magnet_offset] [-e sin,cos,gain,phase] [-a amplitude,phase] [-k r,ke | -K] [-r | -p | -j] [-g kp,ki,kd] [-n pairs] [-x delay | -d drift | -f leg,level]\n", pName);
+    printf("  -m            moves only\n");
+    printf("  -n pairs      number of B>A>B move pairs per operating point (default %u)\n", l_u16MovePairs);
+    printf("  -x delay      reverse: command mode B delay [ms] into a last B>A move\n");
+    printf("  -d drift      push the output drift [deg] off mode B after the moves\n");
+    printf("  -f leg,level  GMR IO leg 1..4 stuck at level [LSB] %ums into a last B>A move\n", C_SIM_LEG_FAULT_MS);
+    printf("  -c            calibration only\n");
+    printf("  -v voltage    single supply voltage [10mV] instead of the sweep\n");
+    printf("  -t temp       single temperature [C] instead of the sweep\n");
+    printf("  -s offset     end stop displacement of the calibration run (default %.1f deg)\n", l_dStopOffset);
+    printf("  -o offset     GMR magnet displacement of the calibration run (default %.1f deg)\n", l_dMagnetOffset);
+    printf("  -e errors     GMR sin, cos offset [LSB], cos gain and phase [deg] of the calibration run\n");
+    printf("                (default %.1f,%.1f,%.2f,%.1f)\n", l_adGmrError[0], l_adGmrError[1], l_adGmrError[2], l_adGmrError[3]);
+    printf("  -a harmonic   GMR 4th harmonic angle error amplitude and phase [deg] of the calibration run\n");
+    printf("                (default %.1f,%.1f)\n", l_adGmrHarmonic[0], l_adGmrHarmonic[1]);
+    printf("  -k r,ke       motor resistance and back-EMF constant factors w.r.t. the firmware model (default %.2f,%.2f)\n", l_adMotorScale[0], l_adMotorScale[1]);
+    printf("  -K            calibration runs with the nominal motor and R, Ke each off by +/-20%%\n");
+    printf("  -r            duty ramp controller\n");
+    printf("  -p            PID position loop controller\n");
+    printf("  -j            S-curve trajectory controller\n");
+    printf("  -g kp,ki,kd   PID gains [Q8] (default %u,%u,%u), implies -p\n", C_PID_KP, C_PID_KI, C_PID_KD);
+}
+
+/* ---------------------------------------------
+ * Public Functions Implementation
+ * --------------------------------------------- */
+
+int main(int argc, char * argv[])
+{
+    bool bMoves = true;
+    bool bCalibration = true;
+    int32_t i32Voltage = -1;
+    int32_t i32Temperature = -1000;
+    uint16_t u16MotorRuns = 1u;
+    const double dResistance = g_sHostPlantParam.dResistance;
+    const double dKe = g_sHostPlantParam.dKe;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "-m") == 0)
+        {
+            bCalibration = false;
+        }
+        else if (strcmp(argv[i], "-c") == 0)
+        {
+            bMoves = false;
+        }
+        else if ((strcmp(argv[i], "-n") == 0) && ((i + 1) < argc))
+        {
+            l_u16MovePairs = (uint16_t)strtoul(argv[++i], NULL, 0);
+        }
+        else if ((strcmp(argv[i], "-x") == 0) && ((i + 1) < argc))
+        {
+            l_u32ReverseMs = (uint32_t)strtoul(argv[++i], NULL, 0);
+        }
+        else if ((strcmp(argv[i], "-d") == 0) && ((i + 1) < argc))
+        {
+            l_dDrift = strtod(argv[++i], NULL);
+        }
+        else if ((strcmp(argv[i], "-f") == 0) && ((i + 1) < argc))
+        {
+            unsigned int au[2];
+
+            if ((sscanf(argv[++i], "%u,%u", &au[0], &au[1]) != 2) || (au[0] < 1u) || (au[0] > 4u))
+            {
+                host_sim_Usage(argv[0]);
+                return 1;
+            }
+            l_au16LegFault[0] = (uint16_t)au[0];
+            l_au16LegFault[1] = (uint16_t)au[1];
+        }
+        else if ((strcmp(argv[i], "-v") == 0) && ((i + 1) < argc))
+        {
+            i32Voltage = (int32_t)strtol(argv[++i], NULL, 0);
+        }
+        else if ((strcmp(argv[i], "-t") == 0) && ((i + 1) < argc))
+        {
+            i32Temperature = (int32_t)strtol(argv[++i], NULL, 0);
+        }
+        else if ((strcmp(argv[i], "-s") == 0) && ((i + 1) < argc))
+        {
+            l_dStopOffset = strtod(argv[++i], NULL);
+        }
+        else if ((strcmp(argv[i], "-o") == 0) && ((i + 1) < argc))
+        {
+            l_dMagnetOffset = strtod(argv[++i], NULL);
+        }
+        else if ((strcmp(argv[i], "-e") == 0) && ((i + 1) < argc))
+        {
+            if (sscanf(argv[++i], "%lf,%lf,%lf,%lf", &l_adGmrError[0], &l_adGmrError[1], &l_adGmrError[2], &l_adGmrError[3]) != 4)
+            {
+                host_sim_Usage(argv[0]);
+                return 1;
+            }
+        }
+        else if ((strcmp(argv[i], "-a") == 0) && ((i + 1) < argc))
+        {
+            if (sscanf(argv[++i], "%lf,%lf", &l_adGmrHarmonic[0], &l_adGmrHarmonic[1]) != 2)
+            {
+                host_sim_Usage(argv[0]);
+                return 1;
+            }
+        }
+        else if ((strcmp(argv[i], "-k") == 0) && ((i + 1) < argc))
+        {
+            if (sscanf(argv[++i], "%lf,%lf", &l_adMotorScale[0], &l_adMotorScale[1]) != 2)
+            {
+                host_sim_Usage(argv[0]);
+                return 1;
+            }
+        }
+        else if (strcmp(argv[i], "-K") == 0)
+        {
+            u16MotorRuns = (uint16_t)(sizeof(l_aadMotorCorner) / sizeof(l_aadMotorCorner[0]));
+        }
+        else if (strcmp(argv[i], "-r") == 0)
+        {
+            l_u8CtrlMode = C_MOT_CTRL_RAMP;
+        }
+        else if (strcmp(argv[i], "-p") == 0)
+        {
+            l_u8CtrlMode = C_MOT_CTRL_PID;
+        }
+        else if (strcmp(argv[i], "-j") == 0)
+        {
+            l_u8CtrlMode = C_MOT_CTRL_SCURVE;
+        }
+        else if ((strcmp(argv[i], "-g") == 0) && ((i + 1) < argc))
+        {
+            unsigned int au[3];
+
+            if (sscanf(argv[++i], "%u,%u,%u", &au[0], &au[1], &au[2]) != 3)
+            {
+                host_sim_Usage(argv[0]);
+                return 1;
+            }
+            for (int k = 0; k < 3; k++)
+            {
+                l_au16PidGains[k] = (uint16_t)au[k];
+            }
+            l_u8CtrlMode = C_MOT_CTRL_PID;
+        }
+        else
+        {
+            host_sim_Usage(argv[0]);
+            return 1;
+        }
+    }
+    g_sHostPlantParam.dResistance = dResistance * l_adMotorScale[0];
+    g_sHostPlantParam.dKe = dKe * l_adMotorScale[1];
+
+    if (bMoves)
+    {
+        printf("Moves (valve state 1 = standby, %s)\n", l_apCtrlMode[l_u8CtrlMode]);
+        printf("  V[V]  T[C]  move  time[ms] overshoot[deg] err[deg] energy[mJ] peak[mA] state\n");
+        host_sim_Sweep(host_sim_Moves, i32Voltage, i32Temperature);
+    }
+    for (uint16_t k = 0u; bCalibration && (k < u16MotorRuns); k++)
+    {
+        if (u16MotorRuns > 1u)
+        {
+            l_adMotorScale[0] = l_aadMotorCorner[k][0];
+            l_adMotorScale[1] = l_aadMotorCorner[k][1];
+            g_sHostPlantParam.dResistance = dResistance * l_adMotorScale[0];
+            g_sHostPlantParam.dKe = dKe * l_adMotorScale[1];
+        }
+        printf("Calibration (end stops %+.1f deg, magnet %+.1f deg, GMR offsets %+.1f,%+.1f LSB, gain %.2f, phase %+.1f deg, 4th harmonic %.2f deg at %+.0f deg, motor R x%.2f Ke x%.2f)\n",
+               l_dStopOffset, l_dMagnetOffset, l_adGmrError[0], l_adGmrError[1], l_adGmrError[2], l_adGmrError[3],
+               l_adGmrHarmonic[0], l_adGmrHarmonic[1], l_adMotorScale[0], l_adMotorScale[1]);
+        printf("  V[V]  T[C]  cal    done[ms]  cal[ms]  result B err[deg] A err[deg]\n");
+        host_sim_Sweep(host_sim_Calibration, i32Voltage, i32Temperature);
+    }
+
+    return 0;
+}
+
+/* EOF */
@@ -0,0 +1,48 @@
+/**
+ * @file
+ * @brief Host build replacement of fm_atan2.h
+ * @internal
+ *
+ * @copyright (C) 2025 Melexis N.V.
+ *
+ * Melexis N.V. is supplying this code for use with Melexis N.V. processor based microcontrollers only.
+ *
+ * THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED OR STATUTORY,
+ * INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.  MELEXIS N.V. SHALL NOT IN ANY CIRCUMSTANCES,
+ * BE LIABLE FOR SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON WHATSOEVER.
+ *
+ * @endinternal
+ *
+ * @ingroup host
+ *
+ * @details Fast math arctangent functions. The platform header implements the inlined
+ *          variants in MLX16 assembly and fm.h requires the MLX16 co-processor, the host
+ *          build declares the functions here and implements all of them in host_fastmath.c.
+ */
+
+#ifndef HOST_FM_ATAN2_H
+#define HOST_FM_ATAN2_H
+
+#include <stdint.h>
+
+extern int16_t p_atan2I16(uint16_t y, uint16_t x);
+#define fm_Atan2I16 p_atan2I16
+
+int16_t fm_Atan2HelperDirectLutInlined(uint16_t y, uint16_t x);
+int16_t fm_Atan2HelperInterpolationInlined(uint16_t y, uint16_t x);
+int16_t fm_Atan2HelperDirectLutNonInlined(uint16_t y, uint16_t x);
+int16_t fm_Atan2HelperInterpolationNonInlined(uint16_t y, uint16_t x);
+
+int16_t fm_Atan2U16DirectLutInlined(uint16_t y, uint16_t x);
+int16_t fm_Atan2U16DirectLutNonInlined(uint16_t y, uint16_t x);
+int16_t fm_Atan2I16DirectLutInlined(int16_t y, int16_t x);
+int16_t fm_Atan2I16DirectLutNonInlined(int16_t y, int16_t x);
+int16_t fm_Atan2U16InterpolationInlined(uint16_t y, uint16_t x);
+int16_t fm_Atan2U16InterpolationNonInlined(uint16_t y, uint16_t x);
+int16_t fm_Atan2I16InterpolationInlined(int16_t y, int16_t x);
+int16_t fm_Atan2I16InterpolationNonInlined(int16_t y, int16_t x);
+
+#endif /* HOST_FM_ATAN2_H */
+
+/* EOF */
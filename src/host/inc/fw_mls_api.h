@@ -0,0 +1,32 @@
+/**
+ * @file
+ * @brief Host build replacement of fw_mls_api.h
+ * @internal
+ *
+ * @copyright (C) 2025 Melexis N.V.
+ *
+ * Melexis N.V. is supplying this code for use with Melexis N.V. processor based microcontrollers only.
+ *
+ * THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED OR STATUTORY,
+ * INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.  MELEXIS N.V. SHALL NOT IN ANY CIRCUMSTANCES,
+ * BE LIABLE FOR SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON WHATSOEVER.
+ *
+ * @endinternal
+ *
+ * @ingroup host
+ *
+ * @details MLS API firmware glue.
+ */
+
+#ifndef HOST_FW_MLS_API_H
+#define HOST_FW_MLS_API_H
+
+#include <stdint.h>
+
+extern uint8_t g_u8LinErrorCnt;
+extern uint8_t g_u8LinErrorCode;
+
+#endif /* HOST_FW_MLS_API_H */
+
+/* EOF */
@@ -0,0 +1,47 @@
+/**
+ * @file
+ * @brief Host build replacement of io.h
+ * @internal
+ *
+ * @copyright (C) 2025 Melexis N.V.
+ *
+ * Melexis N.V. is supplying this code for use with Melexis N.V. processor based microcontrollers only.
+ *
+ * THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED OR STATUTORY,
+ * INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.  MELEXIS N.V. SHALL NOT IN ANY CIRCUMSTANCES,
+ * BE LIABLE FOR SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON WHATSOEVER.
+ *
+ * @endinternal
+ *
+ * @ingroup host
+ *
+ * @details IO port accesses are swallowed on the host: writes have no effect and reads return zero.
+ *          Peripheral behaviour that matters for the control loop is provided by host_hw.c.
+ */
+
+#ifndef HOST_IO_H
+#define HOST_IO_H
+
+#include <stdint.h>
+
+/** Write one or more fields of an IO port */
+#define IO_SET(port, ...)           ((void)0)
+
+/** Read a field of an IO port */
+#define IO_GET(port, field)         (0u)
+
+/** Offset of a field within its IO port */
+#define IO_OFFSET(port, field)      (0u)
+
+/** Direct access to the IO port word hosting a field */
+#define IO_HOST(port, field)        (g_u16HostIoDummy)
+
+/** Direct access to the IO port byte hosting a field */
+#define IO_BYTE_HOST(port, field)   (*(volatile uint8_t *)&g_u16HostIoDummy)
+
+extern volatile uint16_t g_u16HostIoDummy;
+
+#endif /* HOST_IO_H */
+
+/* EOF */
@@ -0,0 +1,79 @@
+/**
+ * @file
+ * @brief Host build replacement of lin_api.h
+ * @internal
+ *
+ * @copyright (C) 2025 Melexis N.V.
+ *
+ * Melexis N.V. is supplying this code for use with Melexis N.V. processor based microcontrollers only.
+ *
+ * THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED OR STATUTORY,
+ * INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.  MELEXIS N.V. SHALL NOT IN ANY CIRCUMSTANCES,
+ * BE LIABLE FOR SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON WHATSOEVER.
+ *
+ * @endinternal
+ *
+ * @ingroup host
+ *
+ * @details Minimal Melexis LIN API: types and signal/flag access from lin_signals.h.
+ *          The signal and flag buffers are defined in host_lin.c.
+ */
+
+#ifndef HOST_LIN_API_H
+#define HOST_LIN_API_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <sys_tools.h>
+
+typedef bool l_bool;        /**< LIN boolean */
+typedef uint8_t l_u8;       /**< LIN unsigned 8-bit */
+typedef uint16_t l_u16;     /**< LIN unsigned 16-bit */
+typedef uint16_t l_irqmask; /**< LIN interrupt mask */
+
+/** Positive response to a diagnostic request */
+#define LD_POSITIVE_RESPONSE    (0u)
+/** Negative response to a diagnostic request */
+#define LD_NEGATIVE_RESPONSE    (1u)
+/** No response to a diagnostic request */
+#define LD_NO_RESPONSE          (2u)
+
+static inline l_irqmask l_sys_irq_disable(void)
+{
+    return 0u;
+}
+
+static inline void l_sys_irq_restore(l_irqmask previous)
+{
+    (void)previous;
+}
+
+/** LIN API standard versions */
+#define LIN_1_3  0
+#define LIN_2_0  1
+#define LIN_2_1  2
+#define LIN_2_2  3
+#define SAE_J2602_2012  4
+#define ISO_17987_2016  5
+
+#define vLIN_1_3(ifc) ((ifc ## _API_VERSION == LIN_1_3))
+#define vLIN_2_0(ifc) ((ifc ## _API_VERSION == LIN_2_0))
+#define vLIN_2_1(ifc) ((ifc ## _API_VERSION == LIN_2_1))
+#define vLIN_2_2(ifc) ((ifc ## _API_VERSION == LIN_2_2))
+#define vSAE_J2602_2012(ifc) ((ifc ## _API_VERSION == SAE_J2602_2012))
+#define vISO_17987_2016(ifc) ((ifc ## _API_VERSION == ISO_17987_2016))
+#define vLIN_2_x(ifc) (vLIN_2_0(ifc) || vLIN_2_1(ifc) || vLIN_2_2(ifc))
+#define vLIN_2_1_plus(ifc) (vLIN_2_1(ifc) || vLIN_2_2(ifc))
+
+#define LIN_API_GENERAL_DEFS
+#include <static_assert.h>
+#include "lin_signals.h"
+
+#ifndef ML_NODE_CONFIGURATION_INITIALIZER
+#define ML_NODE_CONFIGURATION_INITIALIZER       SL_NODE_CONFIGURATION_INITIALIZER
+#endif
+
+#endif /* HOST_LIN_API_H */
+
+/* EOF */
@@ -0,0 +1,34 @@
+/**
+ * @file
+ * @brief Host build replacement of mlx16_cfg.h
+ * @internal
+ *
+ * @copyright (C) 2025 Melexis N.V.
+ *
+ * Melexis N.V. is supplying this code for use with Melexis N.V. processor based microcontrollers only.
+ *
+ * THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED OR STATUTORY,
+ * INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.  MELEXIS N.V. SHALL NOT IN ANY CIRCUMSTANCES,
+ * BE LIABLE FOR SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON WHATSOEVER.
+ *
+ * @endinternal
+ *
+ * @ingroup host
+ *
+ * @details The host has no MLX16 coprocessor, the platform headers fall back to their callable C prototypes.
+ */
+
+#ifndef HOST_MLX16_CFG_H
+#define HOST_MLX16_CFG_H
+
+/* the platform headers check the MLX16-GCC release, the host compiler stands in for it */
+#ifndef __MLX16_GCC_MAJOR__
+#define __MLX16_GCC_MAJOR__ 1
+#define __MLX16_GCC_MINOR__ 8
+#endif
+
+
+#endif /* HOST_MLX16_CFG_H */
+
+/* EOF */
@@ -0,0 +1,36 @@
+/**
+ * @file
+ * @brief Host build replacement of plib.h
+ * @internal
+ *
+ * @copyright (C) 2025 Melexis N.V.
+ *
+ * Melexis N.V. is supplying this code for use with Melexis N.V. processor based microcontrollers only.
+ *
+ * THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED OR STATUTORY,
+ * INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.  MELEXIS N.V. SHALL NOT IN ANY CIRCUMSTANCES,
+ * BE LIABLE FOR SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON WHATSOEVER.
+ *
+ * @endinternal
+ *
+ * @ingroup host
+ *
+ * @details Platform library collection header.
+ */
+
+#ifndef HOST_PLIB_H
+#define HOST_PLIB_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <compiler_abstraction.h>
+#include <syslib.h>
+#include <sys_tools.h>
+#include <io.h>
+#include <lib_wdg.h>
+#include <mathlib.h>
+
+#endif /* HOST_PLIB_H */
+
+/* EOF */
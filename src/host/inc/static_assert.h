@@ -0,0 +1,31 @@
+/**
+ * @file
+ * @brief Host build replacement of static_assert.h
+ * @internal
+ *
+ * @copyright (C) 2025 Melexis N.V.
+ *
+ * Melexis N.V. is supplying this code for use with Melexis N.V. processor based microcontrollers only.
+ *
+ * THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED OR STATUTORY,
+ * INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.  MELEXIS N.V. SHALL NOT IN ANY CIRCUMSTANCES,
+ * BE LIABLE FOR SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON WHATSOEVER.
+ *
+ * @endinternal
+ *
+ * @ingroup host
+ *
+ * @details Compile time assertion as used by the platform headers.
+ */
+
+#ifndef HOST_STATIC_ASSERT_H
+#define HOST_STATIC_ASSERT_H
+
+#define ASSERT_CONCAT_(a, b) a ## b
+#define ASSERT_CONCAT(a, b) ASSERT_CONCAT_(a, b)
+#define ASSERT(e) typedef char ASSERT_CONCAT(assert_line_, __LINE__)[(e) ? 1 : -1] __attribute__((unused))
+
+#endif /* HOST_STATIC_ASSERT_H */
+
+/* EOF */
@@ -0,0 +1,40 @@
+/**
+ * @file
+ * @brief Host build replacement of sys_tools.h
+ * @internal
+ *
+ * @copyright (C) 2025 Melexis N.V.
+ *
+ * Melexis N.V. is supplying this code for use with Melexis N.V. processor based microcontrollers only.
+ *
+ * THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED OR STATUTORY,
+ * INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.  MELEXIS N.V. SHALL NOT IN ANY CIRCUMSTANCES,
+ * BE LIABLE FOR SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON WHATSOEVER.
+ *
+ * @endinternal
+ *
+ * @ingroup host
+ *
+ * @details System tools required by the application and the BU-libraries.
+ */
+
+#ifndef HOST_SYS_TOOLS_H
+#define HOST_SYS_TOOLS_H
+
+#include <stdint.h>
+#include <compiler_abstraction.h>
+
+/** MLX16 address type */
+typedef uint16_t address_t;
+
+#ifndef ATTR_PACKED
+#define ATTR_PACKED __attribute__((packed))
+#endif
+
+/** Delay in microseconds (no-op on host) */
+#define DELAY_US(us)            ((void)(us))
+
+#endif /* HOST_SYS_TOOLS_H */
+
+/* EOF */
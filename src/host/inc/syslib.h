@@ -0,0 +1,34 @@
+/**
+ * @file
+ * @brief Host build replacement of syslib.h
+ * @internal
+ *
+ * @copyright (C) 2025 Melexis N.V.
+ *
+ * Melexis N.V. is supplying this code for use with Melexis N.V. processor based microcontrollers only.
+ *
+ * THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED OR STATUTORY,
+ * INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.  MELEXIS N.V. SHALL NOT IN ANY CIRCUMSTANCES,
+ * BE LIABLE FOR SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON WHATSOEVER.
+ *
+ * @endinternal
+ *
+ * @ingroup host
+ *
+ * @details System library definitions required by the application and the BU-libraries.
+ */
+
+#ifndef HOST_SYSLIB_H
+#define HOST_SYSLIB_H
+
+#include <stdint.h>
+#include <compiler_abstraction.h>
+#include <atomic.h>
+
+/** No operation */
+#define NOP()                   do {} while (0)
+
+#endif /* HOST_SYSLIB_H */
+
+/* EOF */
@@ -0,0 +1,38 @@
+/**
+ * @file
+ * @brief Host build replacement of timerlib.h
+ * @internal
+ *
+ * @copyright (C) 2025 Melexis N.V.
+ *
+ * Melexis N.V. is supplying this code for use with Melexis N.V. processor based microcontrollers only.
+ *
+ * THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED OR STATUTORY,
+ * INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.  MELEXIS N.V. SHALL NOT IN ANY CIRCUMSTANCES,
+ * BE LIABLE FOR SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON WHATSOEVER.
+ *
+ * @endinternal
+ *
+ * @ingroup host
+ *
+ * @details Core timer library. The host drives the software timer interrupt directly, so the
+ *          hardware timer programming is reduced to no-ops.
+ */
+
+#ifndef HOST_TIMERLIB_H
+#define HOST_TIMERLIB_H
+
+#include <stdint.h>
+
+/** Timer modes */
+#define STIMER_DISABLE_CLOCK    (0u)
+#define STIMER_1US_CLOCK        (1u)
+
+#define STIMER_INIT(mode, value)    ((void)(mode), (void)(value))
+#define STIMER_SET_MODE(mode)       ((void)(mode))
+#define STIMER_SET_VALUE(value)     ((void)(value))
+
+#endif /* HOST_TIMERLIB_H */
+
+/* EOF */
@@ -43,6 +43,7 @@
 #include "lin22.h"
 #include "pwm.h"
 #include "defines.h"
+#include "profiler.h"
 
 /* ---------------------------------------------
  * Local Defines
@@ -55,6 +56,15 @@
 /** period of checking the COLIN module state (in ms) */
 #define COLIN_CHECK_TIMEOUT (300u * 10u)
 
+#if (PROFILER_ENABLE == 1)
+/** read-by-id: task execution time min/avg/max, id + ProfilerTask_t */
+#define C_RBI_PROFILER_STATS 0x30u
+/** read-by-id: task execution time histogram, id + ProfilerTask_t */
+#define C_RBI_PROFILER_HIST 0x38u
+/** read-by-id: clear the task execution time statistics */
+#define C_RBI_PROFILER_RESET 0x3Fu
+#endif /* (PROFILER_ENABLE == 1) */
+
 /* ---------------------------------------------
  * Local Variables
  * --------------------------------------------- */
@@ -396,8 +406,42 @@ l_u8 ld_read_by_id_callout(l_ifc_handle iii, l_u8 id, l_u8 *pci, l_u8 *data)
         break;
     }
 
+#if (PROFILER_ENABLE == 1)
+    case C_RBI_PROFILER_RESET:
+    {
+        profiler_Reset();
+        *pci = 1u; /* no data */
+        u8Return = LD_POSITIVE_RESPONSE;
+        break;
+    }
+#endif /* (PROFILER_ENABLE == 1) */
+
     default:
-        u8Return = LD_NEGATIVE_RESPONSE;
+#if (PROFILER_ENABLE == 1)
+        if ((id >= C_RBI_PROFILER_STATS) && (id < (C_RBI_PROFILER_STATS + (uint8_t)C_PROFILER_NR_OF_TASKS)))
+        {
+            uint16_t u16Min, u16Avg, u16Max;
+            profiler_GetStats((ProfilerTask_t)(id - C_RBI_PROFILER_STATS), &u16Min, &u16Avg, &u16Max);
+            *pci = 7u; /* 6-bytes of data + 1-byte of pci, [0.1us] */
+            data[0] = (uint8_t)u16Min;
+            data[1] = (uint8_t)(u16Min >> 8);
+            data[2] = (uint8_t)u16Avg;
+            data[3] = (uint8_t)(u16Avg >> 8);
+            data[4] = (uint8_t)u16Max;
+            data[5] = (uint8_t)(u16Max >> 8);
+            u8Return = LD_POSITIVE_RESPONSE;
+        }
+        else if ((id >= C_RBI_PROFILER_HIST) && (id < (C_RBI_PROFILER_HIST + (uint8_t)C_PROFILER_NR_OF_TASKS)))
+        {
+            profiler_GetHistogram((ProfilerTask_t)(id - C_RBI_PROFILER_HIST), data);
+            *pci = (uint8_t)(C_PROFILER_HIST_BINS + 1u); /* 8-bytes of data + 1-byte of pci */
+            u8Return = LD_POSITIVE_RESPONSE;
+        }
+        else
+#endif /* (PROFILER_ENABLE == 1) */
+        {
+            u8Return = LD_NEGATIVE_RESPONSE;
+        }
         break;
     }
 
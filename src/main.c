@@ -55,6 +55,7 @@
 #include "AppValve.h"
 #include "app_sensor.h"
 #include "uart.h"
+#include "profiler.h"
 /* ---------------------------------------------
  * Local Constants
  * --------------------------------------------- */
@@ -180,7 +181,8 @@ void globalVariableInit(void)
 	u16_IGN_PORT_CNT = 0;
 }
 
-int main(void)
+/** Chip, peripherals and application initialization */
+void main_Init(void)
 {
 	/* Initialize watch-dogs, both analogue and digital */
 	WDG_disableIwdIt();
@@ -223,45 +225,75 @@ int main(void)
 #if DEBUG_GPIO_ENABLE == 1
 	softio_configureOutput(DEBUG_PIN);
 #endif
-	/* Application loop */
-	while (1u)
-	{
-		WDG_conditionalAwdRefresh(); /* Restart watchdog */
-		AppLinTask();
+#if PROFILER_ENABLE == 1
+	profiler_Init();
+#endif
+}
+
+/** One pass of the application main loop
+ *
+ * Split from main() so that the host build can drive the loop tick by tick.
+ */
+void main_Task(void)
+{
+	WDG_conditionalAwdRefresh(); /* Restart watchdog */
+	PROFILER_ENTER(C_PROFILER_APP_LIN);
+	AppLinTask();
+	PROFILER_EXIT(C_PROFILER_APP_LIN);
 
-		protection_Task();
-		//     fm_Atan2HelperInterpolationInlined(100,200);
+	PROFILER_ENTER(C_PROFILER_PROTECTION);
+	protection_Task();
+	PROFILER_EXIT(C_PROFILER_PROTECTION);
+	//     fm_Atan2HelperInterpolationInlined(100,200);
 
-		if (g_bUnderVoltageDetected) /* log UV_VS interrupt detection */
-		{
-			g_bUnderVoltageDetected = false; /* IC self detect*/
-		}
-		if (swtimer_isTriggered((uint16_t)SWTIMER_MOT_CTRL_PERIOD) != 0u) // 500s period
-		{
+	if (g_bUnderVoltageDetected) /* log UV_VS interrupt detection */
+	{
+		g_bUnderVoltageDetected = false; /* IC self detect*/
+	}
+	if (swtimer_isTriggered((uint16_t)SWTIMER_MOT_CTRL_PERIOD) != 0u) // 500s period
+	{
 #if DEBUG_GPIO_ENABLE == 1
-			//		#if DEBUG_MODE == DEBUG_MOT_CTRL_TASK
-			softio_set(DEBUG_PIN);
+		//		#if DEBUG_MODE == DEBUG_MOT_CTRL_TASK
+		softio_set(DEBUG_PIN);
 //		#endif
 #endif
-			motor_ctrl_handler();
+		PROFILER_ENTER(C_PROFILER_MOT_CTRL);
+		motor_ctrl_handler();
+		PROFILER_EXIT(C_PROFILER_MOT_CTRL);
 #if DEBUG_GPIO_ENABLE == 1
-			//		#if DEBUG_MODE == DEBUG_MOT_CTRL_TASK
-			softio_clr(DEBUG_PIN);
+		//		#if DEBUG_MODE == DEBUG_MOT_CTRL_TASK
+		softio_clr(DEBUG_PIN);
 //		#endif
 #endif
-		}
-		if (swtimer_isTriggered((uint16_t)SWTIMER_APP_CTRL_PERIOD) != 0u) // 1ms period
-		{
-			app_motor_task();
-			AppValveTask();
-			uartTask();
-		}
+	}
+	if (swtimer_isTriggered((uint16_t)SWTIMER_APP_CTRL_PERIOD) != 0u) // 1ms period
+	{
+		PROFILER_ENTER(C_PROFILER_APP_MOTOR);
+		app_motor_task();
+		PROFILER_EXIT(C_PROFILER_APP_MOTOR);
+		PROFILER_ENTER(C_PROFILER_APP_VALVE);
+		AppValveTask();
+		PROFILER_EXIT(C_PROFILER_APP_VALVE);
+		uartTask();
+	}
 
-		background_Handler();
+	background_Handler();
+}
+
+#ifndef UNITTEST
+int main(void)
+{
+	main_Init();
+
+	/* Application loop */
+	while (1u)
+	{
+		main_Task();
 	}
 
 	return (0); /*lint !e527 */
 }
+#endif /* UNITTEST */
 
 /* ---------------------------------------------
  * Callbacks
@@ -0,0 +1,208 @@
+/**
+ * @file
+ * @brief Task execution time profiler.
+ * @internal
+ *
+ * @copyright (C) 2025 Melexis N.V.
+ *
+ * Melexis N.V. is supplying this code for use with Melexis N.V. processor based microcontrollers only.
+ *
+ * THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED OR STATUTORY,
+ * INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.  MELEXIS N.V. SHALL NOT IN ANY CIRCUMSTANCES,
+ * BE LIABLE FOR SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON WHATSOEVER.
+ *
+ * @endinternal
+ *
+ * @ingroup application
+ *
+ * @details Keeps minimum, average, maximum and a histogram of the execution time of every
+ *          profiled task. The statistics are read through the LIN read-by-identifier
+ *          requests 0x30..0x3F, see ld_read_by_id_callout().
+ */
+
+#include <stdint.h>
+#include <plib.h>
+#include "defines.h"
+#include "profiler.h"
+
+#if PROFILER_ENABLE == 1
+
+/* ---------------------------------------------
+ * Local Types
+ * --------------------------------------------- */
+
+/** execution time statistics of a task */
+typedef struct
+{
+    uint16_t u16Min;                             /**< minimum [cycles] */
+    uint16_t u16Max;                             /**< maximum [cycles] */
+    uint16_t u16Count;                           /**< number of samples in u32Sum */
+    uint32_t u32Sum;                             /**< sum of the samples [cycles] */
+    uint16_t au16Hist[C_PROFILER_HIST_BINS];     /**< number of samples per bin */
+} ProfilerStats_t;
+
+/* ---------------------------------------------
+ * Local Variables
+ * --------------------------------------------- */
+
+uint16_t g_au16ProfilerStart[C_PROFILER_NR_OF_TASKS];            /**< CTIMER0 count at task entry */
+static ProfilerStats_t l_asProfilerStats[C_PROFILER_NR_OF_TASKS]; /**< statistics per task */
+
+/* ---------------------------------------------
+ * Local Functions
+ * --------------------------------------------- */
+
+/** Convert CPU cycles to 0.1us, saturated */
+static uint16_t profiler_CyclesToTime(uint16_t u16Cycles)
+{
+    uint32_t u32Time = ((uint32_t)u16Cycles * 10000u) / (uint32_t)FPLL; /* FPLL [kHz] */
+
+    if (u32Time > 0xFFFFu)
+    {
+        u32Time = 0xFFFFu;
+    }
+    return (uint16_t)u32Time;
+}
+
+/* ---------------------------------------------
+ * Public Functions
+ * --------------------------------------------- */
+
+/** Start the free-running profiling timer and clear the statistics */
+void profiler_Init(void)
+{
+    CTimer0_AutoloadInit(eTimerCPUClockDivisionBy1, 0xFFFFu);
+    profiler_Reset();
+}
+
+/** Clear the statistics of all tasks */
+void profiler_Reset(void)
+{
+    uint16_t i, j;
+
+    for (i = 0u; i < (uint16_t)C_PROFILER_NR_OF_TASKS; i++)
+    {
+        ENTER_SECTION(ATOMIC_KEEP_MODE);
+        l_asProfilerStats[i].u16Min = 0xFFFFu;
+        l_asProfilerStats[i].u16Max = 0u;
+        l_asProfilerStats[i].u16Count = 0u;
+        l_asProfilerStats[i].u32Sum = 0u;
+        for (j = 0u; j < C_PROFILER_HIST_BINS; j++)
+        {
+            l_asProfilerStats[i].au16Hist[j] = 0u;
+        }
+        EXIT_SECTION();
+    }
+}
+
+/** Add an execution time sample
+ * @param[in]  eTask      profiled task
+ * @param[in]  u16Cycles  execution time [CPU cycles]
+ */
+void profiler_Record(ProfilerTask_t eTask, uint16_t u16Cycles)
+{
+    ProfilerStats_t *pStats = &l_asProfilerStats[eTask];
+    uint16_t u16Bin = (uint16_t)(u16Cycles >> C_PROFILER_HIST_SHIFT);
+
+    if (u16Cycles < pStats->u16Min)
+    {
+        pStats->u16Min = u16Cycles;
+    }
+    if (u16Cycles > pStats->u16Max)
+    {
+        pStats->u16Max = u16Cycles;
+    }
+    if (pStats->u16Count == 0xFFFFu)
+    {
+        /* keep a running average instead of overflowing */
+        pStats->u16Count >>= 1;
+        pStats->u32Sum >>= 1;
+    }
+    pStats->u16Count++;
+    pStats->u32Sum += u16Cycles;
+
+    if (u16Bin >= C_PROFILER_HIST_BINS)
+    {
+        u16Bin = C_PROFILER_HIST_BINS - 1u;
+    }
+    if (pStats->au16Hist[u16Bin] == 0xFFFFu)
+    {
+        for (uint16_t j = 0u; j < C_PROFILER_HIST_BINS; j++)
+        {
+            pStats->au16Hist[j] >>= 1;
+        }
+    }
+    pStats->au16Hist[u16Bin]++;
+}
+
+/** Read the execution time statistics of a task
+ * @param[in]   eTask    profiled task
+ * @param[out]  pu16Min  minimum execution time [0.1us]
+ * @param[out]  pu16Avg  average execution time [0.1us]
+ * @param[out]  pu16Max  maximum execution time [0.1us]
+ */
+void profiler_GetStats(ProfilerTask_t eTask, uint16_t *pu16Min, uint16_t *pu16Avg, uint16_t *pu16Max)
+{
+    uint16_t u16Min, u16Max, u16Count;
+    uint32_t u32Sum;
+
+    ENTER_SECTION(ATOMIC_KEEP_MODE);
+    u16Min = l_asProfilerStats[eTask].u16Min;
+    u16Max = l_asProfilerStats[eTask].u16Max;
+    u16Count = l_asProfilerStats[eTask].u16Count;
+    u32Sum = l_asProfilerStats[eTask].u32Sum;
+    EXIT_SECTION();
+
+    if (u16Count == 0u)
+    {
+        u16Min = 0u;
+        u32Sum = 0u;
+        u16Count = 1u;
+    }
+    *pu16Min = profiler_CyclesToTime(u16Min);
+    *pu16Avg = profiler_CyclesToTime((uint16_t)(u32Sum / u16Count));
+    *pu16Max = profiler_CyclesToTime(u16Max);
+}
+
+/** Read the execution time histogram of a task
+ *
+ * Every bin covers (1 << C_PROFILER_HIST_SHIFT) CPU cycles, the last bin also holds all
+ * longer samples. The share is scaled to 255 for all samples and rounded up, so a bin
+ * with any sample in it never reads 0.
+ * @param[in]   eTask    profiled task
+ * @param[out]  au8Share share of the samples per bin [1/255]
+ */
+void profiler_GetHistogram(ProfilerTask_t eTask, uint8_t au8Share[C_PROFILER_HIST_BINS])
+{
+    uint16_t au16Hist[C_PROFILER_HIST_BINS];
+    uint32_t u32Total = 0u;
+    uint16_t i;
+
+    ENTER_SECTION(ATOMIC_KEEP_MODE);
+    for (i = 0u; i < C_PROFILER_HIST_BINS; i++)
+    {
+        au16Hist[i] = l_asProfilerStats[eTask].au16Hist[i];
+    }
+    EXIT_SECTION();
+
+    for (i = 0u; i < C_PROFILER_HIST_BINS; i++)
+    {
+        u32Total += au16Hist[i];
+    }
+    for (i = 0u; i < C_PROFILER_HIST_BINS; i++)
+    {
+        if (u32Total != 0u)
+        {
+            au8Share[i] = (uint8_t)((((uint32_t)au16Hist[i] * 255u) + u32Total - 1u) / u32Total);
+        }
+        else
+        {
+            au8Share[i] = 0u;
+        }
+    }
+}
+
+#endif /* PROFILER_ENABLE */
+
+/* EOF */
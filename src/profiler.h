@@ -0,0 +1,92 @@
+/**
+ * @file
+ * @brief Task execution time profiler definitions.
+ *
+ * @internal
+ *
+ * @copyright (C) 2025 Melexis N.V.
+ *
+ * Melexis N.V. is supplying this code for use with Melexis N.V. processor based microcontrollers only.
+ *
+ * THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED OR STATUTORY,
+ * INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.  MELEXIS N.V. SHALL NOT IN ANY CIRCUMSTANCES,
+ * BE LIABLE FOR SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON WHATSOEVER.
+ *
+ * @endinternal
+ *
+ * @ingroup application
+ *
+ * @details The execution time of the 100us and 1ms control path tasks is measured with the
+ *          free-running CTIMER0 (CPU clock, wraps every 65536 cycles) when PROFILER_ENABLE is
+ *          set in defines.h. Interrupts taken while a task runs are included in its time.
+ *          With PROFILER_ENABLE cleared PROFILER_ENTER() and PROFILER_EXIT() compile to nothing.
+ */
+
+#ifndef PROFILER_H_
+#define PROFILER_H_
+
+#include <stdint.h>
+#include "defines.h"
+
+#if PROFILER_ENABLE == 1
+#include <ctimerlib.h>
+#endif /* PROFILER_ENABLE */
+
+/* ---------------------------
+ * Public Defines
+ * --------------------------- */
+
+/** number of histogram bins per task */
+#define C_PROFILER_HIST_BINS 8u
+/** histogram bin width as power of 2 of CPU cycles: 1024 cycles = 32us at 32MHz */
+#define C_PROFILER_HIST_SHIFT 10u
+
+/* ---------------------------
+ * Public Type Definitions
+ * --------------------------- */
+
+/** Profiled tasks */
+typedef enum ProfilerTask_e
+{
+    C_PROFILER_MOT_CTRL = 0U,   /**< motor_ctrl_handler(), 100us */
+    C_PROFILER_ADC_UPDATE,      /**< adc_raw_update(), 100us */
+    C_PROFILER_GMR_ANGLE,       /**< calculate_gmr_angle(), 100us */
+    C_PROFILER_APP_MOTOR,       /**< app_motor_task(), 1ms */
+    C_PROFILER_APP_VALVE,       /**< AppValveTask(), 1ms */
+    C_PROFILER_APP_LIN,         /**< AppLinTask(), main loop */
+    C_PROFILER_PROTECTION,      /**< protection_Task(), main loop */
+    C_PROFILER_NR_OF_TASKS      /**< Size of enum */
+} ProfilerTask_t;
+
+/* ---------------------------
+ * Public Macros
+ * --------------------------- */
+
+#if PROFILER_ENABLE == 1
+extern uint16_t g_au16ProfilerStart[C_PROFILER_NR_OF_TASKS];
+
+/** Mark the start of a profiled task */
+#define PROFILER_ENTER(task) (g_au16ProfilerStart[(task)] = CTimer0_Counter())
+/** Mark the end of a profiled task */
+#define PROFILER_EXIT(task) profiler_Record((task), (uint16_t)(CTimer0_Counter() - g_au16ProfilerStart[(task)]))
+#else
+#define PROFILER_ENTER(task) ((void)0)
+#define PROFILER_EXIT(task) ((void)0)
+#endif /* PROFILER_ENABLE */
+
+/* ---------------------------
+ * Public Function Definitions
+ * --------------------------- */
+
+#if PROFILER_ENABLE == 1
+void profiler_Init(void);
+void profiler_Reset(void);
+void profiler_Record(ProfilerTask_t eTask, uint16_t u16Cycles);
+void profiler_GetStats(ProfilerTask_t eTask, uint16_t *pu16Min, uint16_t *pu16Avg, uint16_t *pu16Max);
+void profiler_GetHistogram(ProfilerTask_t eTask, uint8_t au8Share[C_PROFILER_HIST_BINS]);
+#endif /* PROFILER_ENABLE */
+
+#endif /* PROFILER_H_ */
+
+/* EOF */
@@ -81,6 +81,7 @@
 static uint16_t u16DutyCycleMax;     /**< the maximum pwm duty cycle */
 static uint16_t u16LastDiagErr = 0u; /**< last diagnostic error code */
 static uint16_t u16LTcopy[4];        /**< LT registers values to be written during Master1 End ISR */
+static uint16_t u16BrakeAcc = 0u;    /**< brake modulator accumulator */
 
 uint16_t pwm_u16DutyCycle = 0u;                                  /**< [0:C_CORRECTION_RATIO_MAX] PWM duty cycle */
 uint16_t g_u16HalfPwmMin = (uint16_t)((0.05f * PWM_PERIOD) / 2); /**< [0:PWM_PERIOD/2] min pwm period */
@@ -391,6 +392,36 @@ void pwm_Stop(void)
     IO_SET(PWM_SLAVE2, LT, 0u);  /* W */
     IO_SET(PWM_SLAVE3, LT, 0u);  /* T */
 }
+/** Brake the motor with the bridge
+ *
+ * The winding is shorted through both low sides. Below full strength the short
+ * is modulated over the calls: a first order sigma-delta shorts the winding for
+ * u16Strength / C_PWMOUT_MAX_DUTY of the calls and opens the bridge for the
+ * others, the winding current then decays through the body diodes into the supply.
+ * To be called with a fixed period, the motor control calls it every 100us.
+ * @param[in]  u16Strength  brake strength [0:C_PWMOUT_MAX_DUTY], C_PWMOUT_MAX_DUTY: permanent short.
+ */
+void pwm_Brake(uint16_t u16Strength)
+{
+    if (u16Strength >= C_PWMOUT_MAX_DUTY)
+    {
+        u16BrakeAcc = 0u;
+        pwm_Stop();
+    }
+    else
+    {
+        u16BrakeAcc += u16Strength;
+        if (u16BrakeAcc >= C_PWMOUT_MAX_DUTY)
+        {
+            u16BrakeAcc -= C_PWMOUT_MAX_DUTY;
+            pwm_Stop();
+        }
+        else
+        {
+            pwm_Off();
+        }
+    }
+}
 void pwm_Off(void)
 {
     /* all phases connected to GND */
@@ -57,6 +57,7 @@ void pwm_Start(uint8_t dir, uint16_t u16DutyCycle);
 void pwm_SetDutyCycle(uint8_t dir, uint16_t u16DutyCycle);
 void pwm_SetMaxDutyCycle(uint16_t u16DutyCycle);
 void pwm_Stop(void);
+void pwm_Brake(uint16_t u16Strength);
 void pwm_Off(void);
 void pwm_Disable(void);
 
@@ -22,6 +22,9 @@
 #ifndef SYSTEM_H_
 #define SYSTEM_H_
 
+void main_Init(void);
+void main_Task(void);
+
 static INLINE uint16_t get_u16SupplyVoltage(void)
 {
     extern uint16_t g_u16SupplyVoltage;
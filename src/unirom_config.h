@@ -32,7 +32,7 @@ typedef struct
 /** user config struct */
 typedef struct user_pattern
 {
-    page_t page[3];
+    page_t page[12];
 } user_pattern_t;
 
 #endif /* UNIROM_CONFIG_H_ */